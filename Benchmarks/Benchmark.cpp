@@ -0,0 +1,233 @@
+#include "Benchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include "../Common/ThreadPool.h"
+
+BenchmarkRunner::BenchmarkRunner()
+{
+}
+
+bool BenchmarkRunner::ParseCommandLine(int argc, char** argv)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "-h" || arg == "--help")
+		{
+			showUsage(argv[0]);
+			return false;
+		}
+		else if (arg == CMD_IDs.Filter && i + 1 < argc)
+			m_filter = argv[++i];
+		else if (arg == CMD_IDs.Output && i + 1 < argc)
+			m_outputPath = argv[++i];
+		else if (arg == CMD_IDs.Repetitions && i + 1 < argc)
+			m_repetitions = std::stoi(argv[++i]);
+		else if (arg == CMD_IDs.MinTime && i + 1 < argc)
+			m_minSeconds = std::stod(argv[++i]);
+		else if (arg == CMD_IDs.Seed && i + 1 < argc)
+			m_seed = std::stoull(argv[++i]);
+		else if (arg == CMD_IDs.Threads && i + 1 < argc)
+			m_threadsAmount = ThreadPool::ResolveThreadsAmount(std::stoi(argv[++i]));
+		else if (arg == CMD_IDs.MaxQueens && i + 1 < argc)
+			m_maxQueensAmount = std::stoi(argv[++i]);
+		else
+		{
+			std::cerr << "ERROR: Input Error! Unknown argument '" << arg << "'!\n";
+			showUsage(argv[0]);
+			return false;
+		}
+	}
+
+	if (m_repetitions < 1 || m_minSeconds <= 0 || m_maxQueensAmount < 8)
+	{
+		std::cerr << "ERROR: Input Error! At least one repetition, a positive minimum time and at least 8 queens are needed!\n";
+		return false;
+	}
+	return true;
+}
+
+void BenchmarkRunner::showUsage(char* appExecutionPath)
+{
+	BenchmarkRunner defaults;
+	std::cout
+		<< "Usage: " << appExecutionPath << " <option(s)>\n\n"
+		<< "Options:\n"
+		<< "\t-h,--help\t\tShow this help message.\n"
+		<< "\t" << defaults.CMD_IDs.Filter << " <TEXT>\t\tOnly benchmarks whose name contains TEXT. Default: all\n"
+		<< "\t" << defaults.CMD_IDs.Output << " <FILE>\t\tJson file with the results. Default: " << defaults.m_outputPath << "\n"
+		<< "\t" << defaults.CMD_IDs.Repetitions << " <NUM>\tMeasurements per benchmark, the median is reported. Default: " << defaults.m_repetitions << "\n"
+		<< "\t" << defaults.CMD_IDs.MinTime << " <SECONDS>\tMinimum time of one measurement of a micro benchmark. Default: " << defaults.m_minSeconds << "\n"
+		<< "\t" << defaults.CMD_IDs.Seed << " <NUM>\t\tSeed of all benchmarks, keep it fixed to compare two versions. Default: " << defaults.m_seed << "\n"
+		<< "\t" << defaults.CMD_IDs.Threads << " <NUM>\t\tThreads of the solvers, 0 uses all hardware threads. Default: " << defaults.m_threadsAmount << "\n"
+		<< "\t" << defaults.CMD_IDs.MaxQueens << " <NUM>\tLargest board of the N-Queens end-to-end benchmarks. Default: " << defaults.m_maxQueensAmount << "\n";
+}
+
+void BenchmarkRunner::Measure(const std::string& name, const std::string& unit, const std::function<void(const long long&)>& body)
+{
+	if (!isSelected(name))
+		return;
+
+	//warm up and find an amount which takes at least the minimum time
+	long long amount = 1;
+	while (true)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		body(amount);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		if (seconds >= m_minSeconds)
+			break;
+		amount = seconds > 0 ? std::max(amount * 2, static_cast<long long>(amount * 1.2 * m_minSeconds / seconds)) : amount * 10;
+	}
+
+	std::vector<std::pair<double, long long>> repetitions;
+	for (int repetition = 0; repetition < m_repetitions; ++repetition)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		body(amount);
+		repetitions.emplace_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count(), amount);
+	}
+
+	BenchmarkResult result;
+	result.Name = name;
+	result.Unit = unit;
+	std::vector<BenchmarkCounters> counters(repetitions.size());
+	addResult(result, repetitions, counters);
+}
+
+void BenchmarkRunner::MeasureRun(const std::string& name, const std::string& unit, const std::function<long long(BenchmarkCounters&)>& body)
+{
+	if (!isSelected(name))
+		return;
+
+	//every repetition is the same run, so it's repeated as it is without a warm up
+	std::vector<std::pair<double, long long>> repetitions;
+	std::vector<BenchmarkCounters> counters(m_repetitions);
+	for (int repetition = 0; repetition < m_repetitions; ++repetition)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		long long operations = body(counters[repetition]);
+		repetitions.emplace_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count(), operations);
+	}
+
+	BenchmarkResult result;
+	result.Name = name;
+	result.Unit = unit;
+	addResult(result, repetitions, counters);
+}
+
+void BenchmarkRunner::addResult(BenchmarkResult& result, std::vector<std::pair<double, long long>>& repetitions, std::vector<BenchmarkCounters>& counters)
+{
+	//the median is ordered by the time per operation, a repetition with less operations isn't counted as faster
+	std::vector<int> order(repetitions.size());
+	for (int i = 0; i < order.size(); ++i)
+		order[i] = i;
+	auto getSecondsPerOperation = [&repetitions](const int& index) { return repetitions[index].first / std::max(repetitions[index].second, 1LL); };
+	std::sort(order.begin(), order.end(), [&](const int& left, const int& right) { return getSecondsPerOperation(left) < getSecondsPerOperation(right); });
+
+	int median = order[order.size() / 2];
+	result.Repetitions = static_cast<int>(repetitions.size());
+	result.Operations = repetitions[median].second;
+	result.MinSeconds = repetitions[order.front()].first;
+	result.MedianSeconds = repetitions[median].first;
+	result.MaxSeconds = repetitions[order.back()].first;
+	result.NanosecondsPerOperation = getSecondsPerOperation(median) * 1e9;
+	result.Counters = counters[median];
+	m_results.push_back(result);
+
+	std::cout << std::left << std::setw(56) << result.Name << std::right << std::setw(14) << std::fixed << std::setprecision(1) << result.NanosecondsPerOperation << " ns/" << result.Unit;
+	for (auto& counter : result.Counters)
+		std::cout << "  " << counter.first << "=" << std::defaultfloat << std::setprecision(10) << counter.second;
+	std::cout << std::endl;
+}
+
+bool BenchmarkRunner::WriteJson() const
+{
+	std::ofstream file(m_outputPath);
+	if (!file.is_open())
+	{
+		std::cerr << "ERROR: Could not save file '" << m_outputPath << "'!\n";
+		return false;
+	}
+
+	file << std::setprecision(10);
+	file << "{\n"
+		<< "  \"context\": {\n"
+		<< "    \"seed\": " << m_seed << ",\n"
+		<< "    \"threads\": " << m_threadsAmount << ",\n"
+		<< "    \"repetitions\": " << m_repetitions << ",\n"
+		<< "    \"min_time\": " << m_minSeconds << ",\n"
+		<< "    \"instruction_set\": \"" << getInstructionSet() << "\"\n"
+		<< "  },\n"
+		<< "  \"benchmarks\": [";
+	for (int i = 0; i < m_results.size(); ++i)
+	{
+		const BenchmarkResult& result = m_results[i];
+		file << (i == 0 ? "\n" : ",\n")
+			<< "    {\n"
+			<< "      \"name\": \"" << escapeJson(result.Name) << "\",\n"
+			<< "      \"unit\": \"" << escapeJson(result.Unit) << "\",\n"
+			<< "      \"repetitions\": " << result.Repetitions << ",\n"
+			<< "      \"operations\": " << result.Operations << ",\n"
+			<< "      \"min_seconds\": " << result.MinSeconds << ",\n"
+			<< "      \"median_seconds\": " << result.MedianSeconds << ",\n"
+			<< "      \"max_seconds\": " << result.MaxSeconds << ",\n"
+			<< "      \"ns_per_operation\": " << result.NanosecondsPerOperation << ",\n"
+			<< "      \"operations_per_second\": " << (result.NanosecondsPerOperation > 0 ? 1e9 / result.NanosecondsPerOperation : 0.0) << ",\n"
+			<< "      \"counters\": {";
+		for (int c = 0; c < result.Counters.size(); ++c)
+			file << (c == 0 ? " " : ", ") << "\"" << escapeJson(result.Counters[c].first) << "\": " << result.Counters[c].second;
+		file << (result.Counters.empty() ? "}\n" : " }\n")
+			<< "    }";
+	}
+	file << "\n  ]\n}\n";
+	std::cout << "Results saved in '" << m_outputPath << "'" << std::endl;
+	return true;
+}
+
+unsigned long long BenchmarkRunner::GetSeed() const
+{
+	return m_seed;
+}
+
+int BenchmarkRunner::GetThreadsAmount() const
+{
+	return m_threadsAmount;
+}
+
+int BenchmarkRunner::GetMaxQueensAmount() const
+{
+	return m_maxQueensAmount;
+}
+
+bool BenchmarkRunner::isSelected(const std::string& name) const
+{
+	return m_filter.empty() || name.find(m_filter) != std::string::npos;
+}
+
+std::string BenchmarkRunner::escapeJson(const std::string& text)
+{
+	std::string escaped;
+	for (char character : text)
+	{
+		if (character == '"' || character == '\\')
+			escaped.push_back('\\');
+		escaped.push_back(character);
+	}
+	return escaped;
+}
+
+std::string BenchmarkRunner::getInstructionSet()
+{
+	//the equation evaluator picks its kernel at compile time, results of different builds aren't comparable
+#if defined(__AVX512F__)
+	return "AVX-512";
+#elif defined(__AVX2__)
+	return "AVX2";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <utility>
+
+typedef std::vector<std::pair<std::string, double>> BenchmarkCounters;
+
+struct BenchmarkResult
+{
+	std::string Name;
+	std::string Unit; //what one operation is, e.g. "individual" or "generation"
+	int Repetitions = 0;
+	long long Operations = 0; //of the median repetition
+	double MinSeconds = 0;
+	double MedianSeconds = 0;
+	double MaxSeconds = 0;
+	double NanosecondsPerOperation = 0; //of the median repetition
+	BenchmarkCounters Counters; //of the median repetition
+};
+
+//stores a value where the optimizer can't prove that it's unused
+template<typename T>
+inline void KeepResult(const T& value)
+{
+	static volatile T sink;
+	sink = value;
+	(void)sink;
+}
+
+//measures every benchmark several times and keeps the median, the results are printed and saved as json to compare two versions
+class BenchmarkRunner
+{
+public:
+	BenchmarkRunner();
+
+	bool ParseCommandLine(int argc, char** argv);
+
+	//micro benchmark, body(amount) performs amount operations, the amount grows until one repetition takes the minimum time
+	void Measure(const std::string& name, const std::string& unit, const std::function<void(const long long&)>& body);
+	//end-to-end benchmark, body performs one complete run with a fixed seed and returns how many operations it needed
+	void MeasureRun(const std::string& name, const std::string& unit, const std::function<long long(BenchmarkCounters&)>& body);
+
+	bool WriteJson() const;
+
+	unsigned long long GetSeed() const;
+	int GetThreadsAmount() const;
+	int GetMaxQueensAmount() const;
+
+private:
+	static void showUsage(char* appExecutionPath);
+	bool isSelected(const std::string& name) const;
+	void addResult(BenchmarkResult& result, std::vector<std::pair<double, long long>>& repetitions, std::vector<BenchmarkCounters>& counters);
+	static std::string escapeJson(const std::string& text);
+	static std::string getInstructionSet();
+
+	std::string m_filter;
+	std::string m_outputPath = "benchmark.json";
+	int m_repetitions = 5;
+	double m_minSeconds = 0.1;
+	unsigned long long m_seed = 42;
+	int m_threadsAmount = 1;
+	int m_maxQueensAmount = 4096;
+	std::vector<BenchmarkResult> m_results;
+
+	const struct CmdIdentifier
+	{
+		const char* Filter = "--filter";
+		const char* Output = "--output";
+		const char* Repetitions = "--repetitions";
+		const char* MinTime = "--min-time";
+		const char* Seed = "--seed";
+		const char* Threads = "--threads";
+		const char* MaxQueens = "--max-queens";
+	} CMD_IDs;
+};
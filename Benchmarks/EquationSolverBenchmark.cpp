@@ -0,0 +1,213 @@
+#include "EquationSolverBenchmark.h"
+#include <algorithm>
+#include <iostream>
+#include <climits>
+#include "../Evolutionary Algorithms/EquationSolver.h"
+#include "../Evolutionary Algorithms/TopSelection.h"
+
+namespace
+{
+	const int individualsAmount = 4096;
+}
+
+void EquationSolverBenchmark::Run(BenchmarkRunner& runner)
+{
+	measureEquation(runner);
+
+	measureSelection(runner, 10, 50);
+	measureSelection(runner, 100, 700);
+
+	measureGeneration(runner, true);
+	measureGeneration(runner, false);
+
+	const std::vector<std::string> range = { "--i-range", "-100", "100", "--m-range", "-5", "5" };
+	auto withRange = [&range](std::vector<std::string> arguments)
+	{
+		arguments.insert(arguments.end(), range.begin(), range.end());
+		return arguments;
+	};
+	measureSolve(runner, "es/solve/one_plus_one", withRange({ "--strategy", "(1+1)", "--self-adaptive", "10" }));
+	measureSolve(runner, "es/solve/mu_plus_lambda", withRange({ "--strategy", "(m+l)", "--mu", "10", "--lambda", "50" }));
+	measureSolve(runner, "es/solve/mu_comma_lambda", withRange({ "--strategy", "(m,l)", "--mu", "10", "--lambda", "50" }));
+	measureSolve(runner, "es/solve/mu_slash_roh_plus_lambda", withRange({ "--strategy", "(m/r+l)", "--mu", "10", "--lambda", "50", "--roh", "3", "--combination" }));
+	measureSolve(runner, "es/solve/mu_slash_roh_comma_lambda", withRange({ "--strategy", "(m/r,l)", "--mu", "10", "--lambda", "50", "--roh", "3", "--melting", "--self-adaptive", "10" }));
+	measureSolve(runner, "es/solve/cma", withRange({ "--strategy", "(cma)", "--lambda", "20" }));
+}
+
+bool EquationSolverBenchmark::VerifyEquation(const unsigned long long& seed)
+{
+	//small genes, genes up to the domain limit and genes outside of it, the amount leaves a tail for the scalar path
+	const int amount = 1027;
+	const int ranges[][2] = { { -100, 100 }, { -EquationObjective::MaxGeneMagnitude, EquationObjective::MaxGeneMagnitude } };
+	RandomEngine randomEngine(seed);
+	std::vector<int> genes[EquationGenome::Size];
+	const int* genePointers[EquationGenome::Size];
+	for (int geneIndex = 0; geneIndex < EquationGenome::Size; ++geneIndex)
+	{
+		genes[geneIndex].resize(amount);
+		for (int& gene : genes[geneIndex])
+		{
+			int rangeIndex = Random::Index(randomEngine, 3);
+			//the whole int range from the raw bits
+			gene = rangeIndex < 2 ? Random::Integer(randomEngine, ranges[rangeIndex][0], ranges[rangeIndex][1]) : static_cast<int>(static_cast<unsigned>(randomEngine() >> 32));
+		}
+		genePointers[geneIndex] = genes[geneIndex].data();
+	}
+	//a solution whose terms only fit into 64 bit, 3x^2 and 3b^2 cancel each other
+	const int solutionIndex = 700;
+	const int solution[] = { EquationObjective::MaxGeneMagnitude, 7, 245, -EquationObjective::MaxGeneMagnitude };
+	for (int geneIndex = 0; geneIndex < EquationGenome::Size; ++geneIndex)
+		genes[geneIndex][solutionIndex] = solution[geneIndex];
+
+	//every start offset once, so every individual is evaluated in every lane
+	std::vector<int> qualities(amount);
+	for (int begin = 0; begin < 16; ++begin)
+	{
+		int foundIndex = EquationEvaluator::Evaluate(genePointers, qualities.data(), begin, amount, EquationObjective(), EquationConstraint());
+		int expectedIndex = -1;
+		for (int i = begin; i < amount; ++i)
+		{
+			int expectedQuality = genes[2][i] > genes[3][i] ? EquationObjective::GetQuality(genes[0][i], genes[1][i], genes[2][i], genes[3][i]) : INT_MAX;
+			if (expectedQuality == 0 && expectedIndex < 0)
+				expectedIndex = i;
+			if (qualities[i] != expectedQuality)
+			{
+				std::cerr << "ERROR: Vectorized quality " << qualities[i] << " of (" << genes[0][i] << ", " << genes[1][i] << ", " << genes[2][i] << ", " << genes[3][i] << ") differs from the scalar quality " << expectedQuality << "!\n";
+				return false;
+			}
+		}
+		if (foundIndex != expectedIndex || expectedIndex != solutionIndex)
+		{
+			std::cerr << "ERROR: Vectorized evaluation found solution " << foundIndex << " instead of " << expectedIndex << "!\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+void EquationSolverBenchmark::measureEquation(BenchmarkRunner& runner)
+{
+	//structure of arrays as the strategies keep their populations
+	RandomEngine randomEngine(runner.GetSeed());
+	std::vector<int> genes[EquationGenome::Size];
+	const int* genePointers[EquationGenome::Size];
+	for (int geneIndex = 0; geneIndex < EquationGenome::Size; ++geneIndex)
+	{
+		genes[geneIndex].resize(individualsAmount);
+		Random::FillIntegers(genes[geneIndex].data(), individualsAmount, -100, 100, randomEngine);
+		genePointers[geneIndex] = genes[geneIndex].data();
+	}
+	std::vector<int> qualities(individualsAmount);
+
+	EquationSolver solver;
+	runner.Measure("es/equation/difference", "individual", [&](const long long& amount)
+	{
+		int differenceSum = 0;
+		for (long long i = 0; i < amount; ++i)
+		{
+			int index = static_cast<int>(i % individualsAmount);
+			differenceSum += solver.getDiffenceOfEvolutionStrategyEquation(genes[0][index], genes[1][index], genes[2][index], genes[3][index]);
+		}
+		KeepResult(differenceSum);
+	});
+
+	//whole populations at once, the last one only up to the amount, so the time is divided by the individuals which were evaluated
+	runner.Measure("es/equation/evaluate_population", "individual", [&](const long long& amount)
+	{
+		int solutionSum = 0;
+		for (long long i = 0; i < amount; i += individualsAmount)
+			solutionSum += EquationEvaluator::Evaluate(genePointers, qualities.data(), 0, static_cast<int>(std::min<long long>(individualsAmount, amount - i)), EquationObjective(), EquationConstraint());
+		KeepResult(solutionSum + qualities[0]);
+	});
+}
+
+void EquationSolverBenchmark::measureSelection(BenchmarkRunner& runner, const int& mu, const int& lambda)
+{
+	//plus selection ranks the parents and the children, comma selection only the children
+	RandomEngine randomEngine(runner.GetSeed());
+	std::vector<int> qualities(mu + lambda);
+	Random::FillIntegers(qualities.data(), mu + lambda, 0, 1000, randomEngine);
+	TopSelection topSelection;
+	std::vector<int> selection;
+	const std::string size = "/mu=" + std::to_string(mu) + ",lambda=" + std::to_string(lambda);
+
+	runner.Measure("es/selection/plus" + size, "selection", [&](const long long& amount)
+	{
+		for (long long i = 0; i < amount; ++i)
+			topSelection.Select(qualities.data(), mu + lambda, mu, randomEngine, selection);
+		KeepResult(selection[0]);
+	});
+
+	runner.Measure("es/selection/comma" + size, "selection", [&](const long long& amount)
+	{
+		for (long long i = 0; i < amount; ++i)
+			topSelection.Select(qualities.data() + mu, lambda, mu, randomEngine, selection);
+		KeepResult(selection[0]);
+	});
+}
+
+void EquationSolverBenchmark::measureGeneration(BenchmarkRunner& runner, const bool& plusSelection)
+{
+	//the wide start range and the small mutations keep the solution out of reach, every run does the same amount of generations
+	EquationStrategy::Settings settings;
+	settings.Mu = 100;
+	settings.Lambda = 700;
+	settings.PlusSelection = plusSelection;
+	settings.IndividualRandomRange[0] = -1000000;
+	settings.IndividualRandomRange[1] = 1000000;
+	settings.MutationRandomRange[0] = -1;
+	settings.MutationRandomRange[1] = 1;
+	settings.MaxIterations = 200;
+
+	ThreadPool threadPool(runner.GetThreadsAmount());
+	runner.MeasureRun(std::string("es/generation/") + (plusSelection ? "plus" : "comma") + "/mu=100,lambda=700", "generation", [&](BenchmarkCounters& outCounters)
+	{
+		std::vector<RandomEngine> workerEngines(threadPool.GetThreadsAmount());
+		for (int workerIndex = 0; workerIndex < workerEngines.size(); ++workerIndex)
+			Random::SeedStream(workerEngines[workerIndex], runner.GetSeed(), workerIndex + 1);
+		RandomEngine randomEngine(runner.GetSeed());
+
+		EquationStrategy strategy(settings, threadPool, workerEngines);
+		EquationGenome genome;
+		int iterationCounter = 0;
+		int bestQuality = 0;
+		bool solved = strategy.Evolve(randomEngine, iterationCounter, genome, [&bestQuality](const int& quality) { bestQuality = quality; });
+
+		outCounters = { { "generations", iterationCounter }, { "evaluations", static_cast<double>(strategy.GetEvaluationsAmount()) }, { "solved", solved ? 1 : 0 }, { "best_quality", bestQuality } };
+		return static_cast<long long>(std::max(iterationCounter, 1));
+	});
+}
+
+void EquationSolverBenchmark::measureSolve(BenchmarkRunner& runner, const std::string& name, const std::vector<std::string>& arguments)
+{
+	std::vector<std::string> commandLine = { "EquationSolverBenchmark" };
+	commandLine.insert(commandLine.end(), arguments.begin(), arguments.end());
+	commandLine.insert(commandLine.end(), { "--seed", std::to_string(runner.GetSeed()), "--threads", std::to_string(runner.GetThreadsAmount()), "--trace", "none" });
+	std::vector<char*> argv;
+	for (auto& argument : commandLine)
+		argv.push_back(&argument[0]);
+
+	EquationSolver solver;
+	if (!solver.parseCommandLine(static_cast<int>(argv.size()), argv.data()))
+	{
+		std::cerr << "ERROR: Invalid arguments of benchmark '" << name << "'!\n";
+		return;
+	}
+
+	//the same steps as one run of a batch, the parsed settings are copied into every repetition
+	runner.MeasureRun(name, "evaluation", [&solver](BenchmarkCounters& outCounters)
+	{
+		EquationSolver run(solver);
+		run.m_randomEngine.seed(run.m_seed);
+		run.initializeWorkers();
+
+		Individual solution;
+		int iterationCounter = 0;
+		QualityTraceWriter qualityTrace;
+		run.getStrategyFunction()(run.m_maxIterations, iterationCounter, solution, qualityTrace);
+
+		bool solved = iterationCounter < run.m_maxIterations;
+		outCounters = { { "iterations", iterationCounter }, { "evaluations", static_cast<double>(run.m_evaluationsAmount) }, { "solved", solved ? 1 : 0 }, { "best_quality", solved ? 0 : run.m_bestQuality } };
+		return std::max(run.m_evaluationsAmount, 1LL);
+	});
+}
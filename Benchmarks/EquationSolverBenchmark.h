@@ -0,0 +1,20 @@
+#pragma once
+#include <vector>
+#include <string>
+#include "Benchmark.h"
+
+//friend of EquationSolver, the equation and the selections are measured on their own and every strategy with a fixed seed
+class EquationSolverBenchmark
+{
+public:
+	static void Run(BenchmarkRunner& runner);
+	//the vectorized evaluation has to match the scalar reference, also for genes whose terms don't fit into 32 bit
+	static bool VerifyEquation(const unsigned long long& seed);
+
+private:
+	static void measureEquation(BenchmarkRunner& runner);
+	static void measureSelection(BenchmarkRunner& runner, const int& mu, const int& lambda);
+	static void measureGeneration(BenchmarkRunner& runner, const bool& plusSelection);
+	//arguments as on the command line of the solver, without the seed and the threads
+	static void measureSolve(BenchmarkRunner& runner, const std::string& name, const std::vector<std::string>& arguments);
+};
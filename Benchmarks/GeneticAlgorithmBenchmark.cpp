@@ -0,0 +1,150 @@
+#include "GeneticAlgorithmBenchmark.h"
+#include <algorithm>
+#include <string>
+#include "../Genetic Algorithms/GeneticAlgorithm.h"
+
+namespace
+{
+	const int individualsAmount = 64;
+	const int populationSize = 256;
+}
+
+void GeneticAlgorithmBenchmark::Run(BenchmarkRunner& runner)
+{
+	const int microQueensAmounts[] = { 8, 64, 1024 };
+	for (int queensAmount : microQueensAmounts)
+		measureIndividual(runner, queensAmount);
+
+	const int tournamentSizes[] = { 2, 3, 8 };
+	for (int tournamentSize : tournamentSizes)
+		measureTournamentSelection(runner, tournamentSize);
+
+	for (int queensAmount : microQueensAmounts)
+		measurePopulation(runner, queensAmount);
+
+	for (int queensAmount = 8; queensAmount <= runner.GetMaxQueensAmount(); queensAmount *= 2)
+		measureSolve(runner, queensAmount);
+}
+
+void GeneticAlgorithmBenchmark::measureIndividual(BenchmarkRunner& runner, const int& queensAmount)
+{
+	RandomEngine randomEngine(runner.GetSeed());
+	GeneticAlgorithm::IndividualArena arena;
+	arena.Resize(individualsAmount, queensAmount);
+	for (int i = 0; i < individualsAmount; ++i)
+		arena[i].Initialize(randomEngine);
+	const std::string size = "/n=" + std::to_string(queensAmount);
+
+	//the fitness gets reset first, otherwise only the cached value is returned
+	runner.Measure("ga/individual/evaluate_fitness" + size, "individual", [&](const long long& amount)
+	{
+		int fitnessSum = 0;
+		for (long long i = 0; i < amount; ++i)
+		{
+			GeneticAlgorithm::Individual individual = arena[static_cast<int>(i % individualsAmount)];
+			individual.ResetFitness();
+			fitnessSum += individual.EvaluateFitness();
+		}
+		KeepResult(fitnessSum);
+	});
+
+	runner.Measure("ga/individual/count_collisions" + size, "individual", [&](const long long& amount)
+	{
+		int collisionsSum = 0;
+		for (long long i = 0; i < amount; ++i)
+		{
+			GeneticAlgorithm::Individual individual = arena[static_cast<int>(i % individualsAmount)];
+			individual.CountCollisions();
+			collisionsSum += individual.Collisions;
+		}
+		KeepResult(collisionsSum);
+	});
+
+	runner.Measure("ga/individual/one_point_crossover" + size, "couple", [&](const long long& amount)
+	{
+		for (long long i = 0; i < amount; ++i)
+		{
+			int couple = static_cast<int>(i % (individualsAmount / 2));
+			arena[2 * couple].OnePointCrossover(arena[2 * couple + 1], randomEngine);
+		}
+		KeepResult(arena.Collisions[0]);
+	});
+}
+
+void GeneticAlgorithmBenchmark::measureTournamentSelection(BenchmarkRunner& runner, const int& tournamentSize)
+{
+	//only the fitness values are compared, so small individuals are enough
+	RandomEngine randomEngine(runner.GetSeed());
+	GeneticAlgorithm::Population population;
+	population.Individuals.Resize(populationSize, 8);
+	for (int i = 0; i < populationSize; ++i)
+		population.Individuals.Fitness[i] = -Random::Index(randomEngine, 28);
+	std::vector<int> contestants(populationSize * tournamentSize);
+	Random::FillIndices(contestants.data(), static_cast<int>(contestants.size()), populationSize, randomEngine);
+
+	runner.Measure("ga/population/tournament_selection/size=" + std::to_string(tournamentSize), "tournament", [&](const long long& amount)
+	{
+		int winnerSum = 0;
+		for (long long i = 0; i < amount; ++i)
+			winnerSum += population.TournamentSelection(&contestants[(i % populationSize) * tournamentSize], tournamentSize);
+		KeepResult(winnerSum);
+	});
+}
+
+void GeneticAlgorithmBenchmark::measurePopulation(BenchmarkRunner& runner, const int& queensAmount)
+{
+	GAConfig config;
+	ThreadPool threadPool(runner.GetThreadsAmount());
+	std::vector<RandomEngine> workerEngines(threadPool.GetThreadsAmount());
+	for (int workerIndex = 0; workerIndex < workerEngines.size(); ++workerIndex)
+		Random::SeedStream(workerEngines[workerIndex], runner.GetSeed(), workerIndex);
+
+	GeneticAlgorithm::Population population;
+	population.Initialize(queensAmount, populationSize, config, threadPool, workerEngines);
+	const std::string size = "/n=" + std::to_string(queensAmount);
+
+	//the selection needs the best individual of an evaluation, the evaluation of the already evaluated parents is only a scan of the fitness values
+	runner.Measure("ga/population/selection" + size, "generation", [&](const long long& amount)
+	{
+		for (long long i = 0; i < amount; ++i)
+		{
+			population.EvaluateFitness(threadPool);
+			population.Selection(config.TournamentSize, config.PreserveBestIndividual, threadPool, workerEngines);
+		}
+	});
+
+	runner.Measure("ga/population/generation" + size, "generation", [&](const long long& amount)
+	{
+		int fitnessSum = 0;
+		for (long long i = 0; i < amount; ++i)
+		{
+			fitnessSum += population.EvaluateFitness(threadPool);
+			population.CrossoverWithWedding(threadPool, workerEngines);
+			population.Mutate(config.MutationProbability, threadPool, workerEngines);
+			population.Selection(config.TournamentSize, config.PreserveBestIndividual, threadPool, workerEngines);
+		}
+		KeepResult(fitnessSum);
+	});
+}
+
+void GeneticAlgorithmBenchmark::measureSolve(BenchmarkRunner& runner, const int& queensAmount)
+{
+	//the permutation encoding solves the small boards, the generation limit keeps the large ones at a fixed amount of work
+	GAConfig config;
+	config.Encoding = ChromosomeEncoding::Permutation;
+	config.PopulationSize = populationSize;
+	config.MaxIterations = std::max(100, 200000 / queensAmount);
+
+	runner.MeasureRun("ga/solve/n=" + std::to_string(queensAmount), "generation", [&](BenchmarkCounters& outCounters)
+	{
+		GeneticAlgorithm geneticAlgorithm(runner.GetThreadsAmount(), runner.GetSeed());
+		geneticAlgorithm.SetConfig(config);
+		int neededIterations = 0;
+		bool success = false;
+		geneticAlgorithm.SolveNQueensPuzzle(queensAmount, neededIterations, success);
+
+		int generations = std::min(neededIterations, config.MaxIterations);
+		outCounters = { { "generations", generations }, { "solved", success ? 1 : 0 }, { "best_fitness", geneticAlgorithm.GetBestFitness() } };
+		return static_cast<long long>(std::max(generations, 1));
+	});
+}
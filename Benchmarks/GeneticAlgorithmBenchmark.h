@@ -0,0 +1,15 @@
+#pragma once
+#include "Benchmark.h"
+
+//friend of GeneticAlgorithm, the operators of the generation loop are measured on their own and the whole solver on growing boards
+class GeneticAlgorithmBenchmark
+{
+public:
+	static void Run(BenchmarkRunner& runner);
+
+private:
+	static void measureIndividual(BenchmarkRunner& runner, const int& queensAmount);
+	static void measureTournamentSelection(BenchmarkRunner& runner, const int& tournamentSize);
+	static void measurePopulation(BenchmarkRunner& runner, const int& queensAmount);
+	static void measureSolve(BenchmarkRunner& runner, const int& queensAmount);
+};
@@ -0,0 +1,18 @@
+#include "Benchmark.h"
+#include "GeneticAlgorithmBenchmark.h"
+#include "EquationSolverBenchmark.h"
+
+int main(int argc, char** argv)
+{
+	BenchmarkRunner runner;
+	if (!runner.ParseCommandLine(argc, argv))
+		return 1;
+	if (!EquationSolverBenchmark::VerifyEquation(runner.GetSeed()))
+		return 1;
+
+	GeneticAlgorithmBenchmark::Run(runner);
+	EquationSolverBenchmark::Run(runner);
+
+	//0 only if the results were saved, so a script can rely on the file
+	return runner.WriteJson() ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+#include "BatchRunner.h"
+#include "ThreadPool.h"
+#include <mutex>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	//runs [Begin, End) which are still open, the owner takes from the front and thieves take the back half
+	struct RunQueue
+	{
+		std::mutex Mutex;
+		int Begin = 0;
+		int End = 0;
+	};
+
+	bool takeRun(std::vector<std::unique_ptr<RunQueue>>& queues, const int& jobIndex, int& outRunIndex)
+	{
+		RunQueue& ownQueue = *queues[jobIndex];
+		{
+			std::lock_guard<std::mutex> lock(ownQueue.Mutex);
+			if (ownQueue.Begin < ownQueue.End)
+			{
+				outRunIndex = ownQueue.Begin++;
+				return true;
+			}
+		}
+
+		//a stolen range belongs to the thief before it's in its queue, so no run gets lost if another job finds both queues empty
+		int jobsAmount = static_cast<int>(queues.size());
+		for (int offset = 1; offset < jobsAmount; ++offset)
+		{
+			RunQueue& victimQueue = *queues[(jobIndex + offset) % jobsAmount];
+			int begin, end;
+			{
+				std::lock_guard<std::mutex> lock(victimQueue.Mutex);
+				if (victimQueue.Begin >= victimQueue.End)
+					continue;
+				begin = victimQueue.Begin + (victimQueue.End - victimQueue.Begin) / 2;
+				end = victimQueue.End;
+				victimQueue.End = begin;
+			}
+
+			std::lock_guard<std::mutex> lock(ownQueue.Mutex);
+			ownQueue.Begin = begin + 1;
+			ownQueue.End = end;
+			outRunIndex = begin;
+			return true;
+		}
+		return false;
+	}
+
+	struct Percentiles
+	{
+		double Mean = 0, Min = 0, P10 = 0, P50 = 0, P90 = 0, Max = 0;
+	};
+
+	//nearest rank percentiles
+	Percentiles getPercentiles(std::vector<double> values)
+	{
+		Percentiles percentiles;
+		if (values.empty())
+			return percentiles;
+
+		std::sort(values.begin(), values.end());
+		auto getRank = [&values](const double& percent) { return values[std::max(static_cast<int>(std::ceil(percent * values.size())) - 1, 0)]; };
+		for (double value : values)
+			percentiles.Mean += value;
+		percentiles.Mean /= values.size();
+		percentiles.Min = values.front();
+		percentiles.P10 = getRank(0.1);
+		percentiles.P50 = getRank(0.5);
+		percentiles.P90 = getRank(0.9);
+		percentiles.Max = values.back();
+		return percentiles;
+	}
+
+	void collectMetrics(const std::vector<BatchRunResult>& results, std::vector<double>& outIterationsToSolution, std::vector<double>& outSecondsToSolution, std::vector<double>& outQualities)
+	{
+		for (auto& result : results)
+		{
+			if (result.Solved)
+			{
+				outIterationsToSolution.push_back(static_cast<double>(result.Iterations));
+				outSecondsToSolution.push_back(result.Seconds);
+			}
+			outQualities.push_back(result.Quality);
+		}
+	}
+
+	int getSolvedAmount(const std::vector<BatchRunResult>& results)
+	{
+		return static_cast<int>(std::count_if(results.begin(), results.end(), [](const BatchRunResult& result) { return result.Solved; }));
+	}
+}
+
+BatchRunner::BatchRunner(const int& jobsAmount) : m_jobsAmount(std::max(jobsAmount, 1))
+{
+}
+
+void BatchRunner::Run(const int& runsAmount, const std::function<void(const int&, BatchRunResult&)>& run, std::vector<BatchRunResult>& outResults)
+{
+	outResults.assign(runsAmount, BatchRunResult());
+	int jobsAmount = std::max(std::min(m_jobsAmount, runsAmount), 1);
+
+	//every job starts with a contiguous share of the runs
+	std::vector<std::unique_ptr<RunQueue>> queues;
+	for (int jobIndex = 0; jobIndex < jobsAmount; ++jobIndex)
+	{
+		queues.emplace_back(new RunQueue());
+		ThreadPool::GetWorkerRange(jobIndex, jobsAmount, runsAmount, 1, queues.back()->Begin, queues.back()->End);
+	}
+
+	ThreadPool jobs(jobsAmount);
+	jobs.Run([&](int jobIndex)
+	{
+		int runIndex;
+		while (takeRun(queues, jobIndex, runIndex))
+			run(runIndex, outResults[runIndex]);
+	});
+}
+
+bool BatchRunner::WriteSummary(const std::string& path, const std::string& qualityName, const std::vector<BatchRunResult>& results)
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		std::cerr << "ERROR: Could not save file '" << path << "'!\n";
+		return false;
+	}
+
+	std::vector<double> iterationsToSolution, secondsToSolution, qualities;
+	collectMetrics(results, iterationsToSolution, secondsToSolution, qualities);
+	int solvedAmount = getSolvedAmount(results);
+
+	file << "Runs;" << results.size() << "\n"
+		<< "Solved;" << solvedAmount << "\n"
+		<< "SuccessRate;" << (results.empty() ? 0.0 : static_cast<double>(solvedAmount) / results.size()) << "\n\n"
+		<< "Metric;Mean;Min;P10;P50;P90;Max\n";
+	auto writeMetric = [&file](const std::string& name, const std::vector<double>& values)
+	{
+		Percentiles percentiles = getPercentiles(values);
+		file << name << ";" << percentiles.Mean << ";" << percentiles.Min << ";" << percentiles.P10 << ";" << percentiles.P50 << ";" << percentiles.P90 << ";" << percentiles.Max << "\n";
+	};
+	//iterations and seconds only of the solved runs, the unsolved ones all stop at the same limit
+	writeMetric("IterationsToSolution", iterationsToSolution);
+	writeMetric("SecondsToSolution", secondsToSolution);
+	writeMetric(qualityName, qualities);
+
+	file << "\nRun;Seed;Solved;Iterations;Seconds;" << qualityName << "\n";
+	for (int i = 0; i < results.size(); ++i)
+		file << i << ";" << results[i].Seed << ";" << results[i].Solved << ";" << results[i].Iterations << ";" << results[i].Seconds << ";" << results[i].Quality << "\n";
+	return true;
+}
+
+void BatchRunner::PrintSummary(const std::string& qualityName, const std::vector<BatchRunResult>& results)
+{
+	std::vector<double> iterationsToSolution, secondsToSolution, qualities;
+	collectMetrics(results, iterationsToSolution, secondsToSolution, qualities);
+	Percentiles iterations = getPercentiles(iterationsToSolution), seconds = getPercentiles(secondsToSolution), quality = getPercentiles(qualities);
+
+	std::cout << "INFO: Solved " << getSolvedAmount(results) << " of " << results.size() << " runs\n"
+		<< "INFO: Iterations to solution: median " << iterations.P50 << ", P90 " << iterations.P90 << ", max " << iterations.Max << "\n"
+		<< "INFO: Seconds to solution: median " << seconds.P50 << ", P90 " << seconds.P90 << ", max " << seconds.Max << "\n"
+		<< "INFO: " << qualityName << ": median " << quality.P50 << ", P10 " << quality.P10 << ", P90 " << quality.P90 << "\n";
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <functional>
+
+struct BatchRunResult
+{
+	unsigned long long Seed = 0;
+	bool Solved = false;
+	long long Iterations = 0;
+	double Seconds = 0;
+	double Quality = 0; //best fitness or quality at the end of the run
+};
+
+//executes many independent runs on a few jobs, every job works through its own queue of runs and steals from the others when it's empty
+class BatchRunner
+{
+public:
+	explicit BatchRunner(const int& jobsAmount);
+
+	//run(runIndex, outResult) is called once per run, concurrently from all jobs, the results are ordered by the run index
+	void Run(const int& runsAmount, const std::function<void(const int&, BatchRunResult&)>& run, std::vector<BatchRunResult>& outResults);
+
+	//summary with the success rate and the percentiles of iterations, seconds and quality, followed by one line per run
+	static bool WriteSummary(const std::string& path, const std::string& qualityName, const std::vector<BatchRunResult>& results);
+	static void PrintSummary(const std::string& qualityName, const std::vector<BatchRunResult>& results);
+
+private:
+	int m_jobsAmount;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+
+//the formatting the result and trace writers share, they collect their output in a byte buffer before it goes to the file
+namespace BufferAppend
+{
+	inline void UnsignedNumber(std::vector<char>& buffer, unsigned long long number)
+	{
+		//no stream formatting per number, the digits get written back to front
+		char digits[20];
+		int length = 0;
+		do
+		{
+			digits[length++] = static_cast<char>('0' + number % 10);
+			number /= 10;
+		} while (number > 0);
+		while (length > 0)
+			buffer.push_back(digits[--length]);
+	}
+
+	inline void Number(std::vector<char>& buffer, const long long& number)
+	{
+		if (number < 0)
+			buffer.push_back('-');
+		UnsignedNumber(buffer, number < 0 ? 0ull - static_cast<unsigned long long>(number) : static_cast<unsigned long long>(number));
+	}
+
+	//the byte order is fixed so the files can be read on every machine
+	inline void LittleEndian(std::vector<char>& buffer, const unsigned long long& value, const int& bytesAmount)
+	{
+		for (int byte = 0; byte < bytesAmount; ++byte)
+			buffer.push_back(static_cast<char>((value >> (8 * byte)) & 0xFF));
+	}
+}
@@ -0,0 +1,56 @@
+#include "ExportQueue.h"
+#include <algorithm>
+
+ExportQueue::ExportQueue(const int& capacity) : m_capacity(std::max(capacity, 1))
+{
+	m_exportThread = std::thread(&ExportQueue::exportLoop, this);
+}
+
+ExportQueue::~ExportQueue()
+{
+	Finish();
+}
+
+void ExportQueue::Push(Task task)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_spaceCondition.wait(lock, [this] { return static_cast<int>(m_tasks.size()) < m_capacity; });
+	m_tasks.push_back(std::move(task));
+	lock.unlock();
+	m_taskCondition.notify_one();
+}
+
+bool ExportQueue::Finish()
+{
+	if (m_exportThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_finishing = true;
+		}
+		m_taskCondition.notify_one();
+		m_exportThread.join();
+	}
+	return m_failedTasks == 0;
+}
+
+void ExportQueue::exportLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_taskCondition.wait(lock, [this] { return !m_tasks.empty() || m_finishing; });
+		if (m_tasks.empty())
+			break;
+
+		Task task = std::move(m_tasks.front());
+		m_tasks.pop_front();
+		lock.unlock();
+		m_spaceCondition.notify_one();
+
+		bool success = task();
+		lock.lock();
+		if (!success)
+			++m_failedTasks;
+	}
+}
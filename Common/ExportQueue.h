@@ -0,0 +1,35 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//renders, encodes and writes results on one background thread while the solvers go on
+//at most capacity tasks wait in the queue, a full queue blocks Push, so a slow disk slows the solvers down instead of filling the memory
+class ExportQueue
+{
+public:
+	//a task returns false if it failed, it has already printed why
+	typedef std::function<bool()> Task;
+
+	explicit ExportQueue(const int& capacity);
+	~ExportQueue();
+
+	//thread safe, blocks while the queue is full, not allowed after Finish
+	void Push(Task task);
+	//waits until every task is done, false if at least one failed
+	bool Finish();
+
+private:
+	void exportLoop();
+
+	int m_capacity;
+	std::deque<Task> m_tasks;
+	std::thread m_exportThread;
+	std::mutex m_mutex;
+	std::condition_variable m_taskCondition;
+	std::condition_variable m_spaceCondition;
+	int m_failedTasks = 0;
+	bool m_finishing = false;
+};
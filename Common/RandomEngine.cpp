@@ -0,0 +1,66 @@
+#include "RandomEngine.h"
+
+namespace
+{
+	//expands one seed into well mixed state words, recommended by the xoshiro authors
+	unsigned long long splitMix64(unsigned long long& inOutState)
+	{
+		unsigned long long z = (inOutState += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+}
+
+Xoshiro256StarStar::Xoshiro256StarStar(const unsigned long long& seed)
+{
+	this->seed(seed);
+}
+
+void Xoshiro256StarStar::seed(const unsigned long long& seed)
+{
+	unsigned long long splitMixState = seed;
+	for (auto& word : m_state)
+		word = splitMix64(splitMixState);
+}
+
+void Xoshiro256StarStar::Jump()
+{
+	static const unsigned long long jumpPolynomial[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+
+	unsigned long long state[4] = { 0, 0, 0, 0 };
+	for (auto& polynomialWord : jumpPolynomial)
+	{
+		for (int bit = 0; bit < 64; ++bit)
+		{
+			if (polynomialWord & (1ull << bit))
+			{
+				for (int i = 0; i < 4; ++i)
+					state[i] ^= m_state[i];
+			}
+			(*this)();
+		}
+	}
+	for (int i = 0; i < 4; ++i)
+		m_state[i] = state[i];
+}
+
+void Random::SeedStream(Xoshiro256StarStar& engine, const unsigned long long& seed, const unsigned long long& stream)
+{
+	engine.seed(seed);
+	for (unsigned long long i = 0; i < stream; ++i)
+		engine.Jump();
+}
+
+void Random::SeedStream(std::mt19937_64& engine, const unsigned long long& seed, const unsigned long long& stream)
+{
+	//no jump ahead for the mersenne twister, the seed sequence decorrelates the streams instead
+	std::seed_seq sequence = { static_cast<unsigned>(seed), static_cast<unsigned>(seed >> 32), static_cast<unsigned>(stream), static_cast<unsigned>(stream >> 32) };
+	engine.seed(sequence);
+}
+
+unsigned long long Random::DeriveSeed(const unsigned long long& seed, const unsigned long long& index)
+{
+	unsigned long long splitMixState = seed ^ (index * 0xD1B54A32D192ED03ull);
+	return splitMix64(splitMixState);
+}
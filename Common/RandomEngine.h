@@ -0,0 +1,145 @@
+#pragma once
+#include <random>
+#include <cmath>
+
+//xoshiro256** by Blackman and Vigna, fulfills the UniformRandomBitGenerator requirements so it works with the std distributions as well
+class Xoshiro256StarStar
+{
+public:
+	typedef unsigned long long result_type;
+
+	explicit Xoshiro256StarStar(const unsigned long long& seed = 0);
+
+	void seed(const unsigned long long& seed);
+	//advances the engine by 2^128 draws, every jump starts a new stream which doesn't overlap with the previous one
+	void Jump();
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return ~0ull; }
+
+	result_type operator()()
+	{
+		const result_type result = rotateLeft(m_state[1] * 5, 7) * 9;
+		const result_type t = m_state[1] << 17;
+		m_state[2] ^= m_state[0];
+		m_state[3] ^= m_state[1];
+		m_state[1] ^= m_state[2];
+		m_state[0] ^= m_state[3];
+		m_state[2] ^= t;
+		m_state[3] = rotateLeft(m_state[3], 45);
+		return result;
+	}
+
+private:
+	static result_type rotateLeft(const result_type& value, const int& bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	result_type m_state[4];
+};
+
+//the engine of both solvers, define RANDOM_ENGINE_MERSENNE_TWISTER to switch back to the std engine
+#ifdef RANDOM_ENGINE_MERSENNE_TWISTER
+typedef std::mt19937_64 RandomEngine;
+#else
+typedef Xoshiro256StarStar RandomEngine;
+#endif
+
+//distribution helpers without the per call overhead of the std distributions, they work with every 64 bit engine
+namespace Random
+{
+	//stream i of a seed is independent of all other streams of the same seed, meant for one stream per thread or island
+	void SeedStream(Xoshiro256StarStar& engine, const unsigned long long& seed, const unsigned long long& stream);
+	void SeedStream(std::mt19937_64& engine, const unsigned long long& seed, const unsigned long long& stream);
+	//seed of run i of a batch, every run gets a well mixed seed of its own which doesn't depend on the order the runs are executed in
+	unsigned long long DeriveSeed(const unsigned long long& seed, const unsigned long long& index);
+
+	//[0, range) by the multiply-shift of 32 random bits, no division and no rejection, the bias is negligible for ranges far below 2^32
+	template<typename Engine>
+	int Index(Engine& engine, const int& range)
+	{
+		return static_cast<int>(((engine() >> 32) * static_cast<unsigned long long>(range)) >> 32);
+	}
+
+	//[min, max]
+	template<typename Engine>
+	int Integer(Engine& engine, const int& min, const int& max)
+	{
+		return min + Index(engine, max - min + 1);
+	}
+
+	//[0, 1) with 53 random bits
+	template<typename Engine>
+	double Probability(Engine& engine)
+	{
+		return (engine() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	//two indices in [0, range) per engine draw
+	template<typename Engine>
+	void FillIndices(int* outIndices, const int& amount, const int& range, Engine& engine)
+	{
+		int i = 0;
+		for (; i + 1 < amount; i += 2)
+		{
+			unsigned long long bits = engine();
+			outIndices[i] = static_cast<int>(((bits & 0xFFFFFFFFull) * range) >> 32);
+			outIndices[i + 1] = static_cast<int>(((bits >> 32) * range) >> 32);
+		}
+		if (i < amount)
+			outIndices[i] = Index(engine, range);
+	}
+
+	//two integers in [min, max] per engine draw
+	template<typename Engine>
+	void FillIntegers(int* outIntegers, const int& amount, const int& min, const int& max, Engine& engine)
+	{
+		FillIndices(outIntegers, amount, max - min + 1, engine);
+		for (int i = 0; i < amount; ++i)
+			outIntegers[i] += min;
+	}
+
+	template<typename Engine>
+	void FillProbabilities(double* outProbabilities, const int& amount, Engine& engine)
+	{
+		for (int i = 0; i < amount; ++i)
+			outProbabilities[i] = Probability(engine);
+	}
+
+	//[min, max)
+	template<typename Engine>
+	double Real(Engine& engine, const double& min, const double& max)
+	{
+		return min + (max - min) * Probability(engine);
+	}
+
+	//standard normal distribution by Box-Muller, the second value of the pair is dropped
+	template<typename Engine>
+	double Normal(Engine& engine)
+	{
+		double radius = std::sqrt(-2.0 * std::log(1.0 - Probability(engine)));
+		return radius * std::cos(6.283185307179586 * Probability(engine));
+	}
+
+	//both values of every Box-Muller pair
+	template<typename Engine>
+	void FillNormals(double* outNormals, const int& amount, Engine& engine)
+	{
+		for (int i = 0; i < amount; i += 2)
+		{
+			double radius = std::sqrt(-2.0 * std::log(1.0 - Probability(engine)));
+			double angle = 6.283185307179586 * Probability(engine);
+			outNormals[i] = radius * std::cos(angle);
+			if (i + 1 < amount)
+				outNormals[i + 1] = radius * std::sin(angle);
+		}
+	}
+
+	template<typename Engine>
+	void FillReals(double* outReals, const int& amount, const double& min, const double& max, Engine& engine)
+	{
+		for (int i = 0; i < amount; ++i)
+			outReals[i] = Real(engine, min, max);
+	}
+}
@@ -0,0 +1,209 @@
+#include "ResultWriter.h"
+#include "BufferAppend.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+const char* ResultFormat::GetFileExtension(const Enum& format)
+{
+	switch (format)
+	{
+	case JsonLines: return ".jsonl";
+	case Binary: return ".result";
+	default: return "";
+	}
+}
+
+ResultWriter::ResultWriter()
+{
+}
+
+ResultWriter::~ResultWriter()
+{
+	if (m_format != ResultFormat::None)
+		Close();
+}
+
+bool ResultWriter::Open(const std::string& path, const ResultFormat::Enum& format, const std::string& solver, const std::vector<RunParameter>& parameters)
+{
+	m_format = format;
+	m_path = path;
+	if (m_format == ResultFormat::None)
+		return true;
+
+	m_file.open(path, std::ios::out | std::ios::binary);
+	if (!m_file.is_open())
+	{
+		std::cerr << "ERROR: Could not save file '" << path << "'!\n";
+		m_format = ResultFormat::None;
+		return false;
+	}
+
+	m_buffer.clear();
+	m_buffer.reserve(m_bufferCapacity);
+	if (m_format == ResultFormat::JsonLines)
+	{
+		//the prefix is the same for every line, so it's built only once
+		m_buffer.push_back('{');
+		appendJsonString("solver");
+		m_buffer.push_back(':');
+		appendJsonString(solver);
+		m_buffer.push_back(',');
+		appendJsonString("parameters");
+		m_buffer.insert(m_buffer.end(), { ':', '{' });
+		for (int i = 0; i < parameters.size(); ++i)
+		{
+			if (i > 0)
+				m_buffer.push_back(',');
+			appendJsonString(parameters[i].Name);
+			m_buffer.push_back(':');
+			if (parameters[i].IsNumber)
+				m_buffer.insert(m_buffer.end(), parameters[i].Value.begin(), parameters[i].Value.end());
+			else
+				appendJsonString(parameters[i].Value);
+		}
+		m_buffer.insert(m_buffer.end(), { '}', ',' });
+		m_jsonPrefix.assign(m_buffer.begin(), m_buffer.end());
+		m_buffer.clear();
+		return true;
+	}
+
+	m_buffer.insert(m_buffer.end(), { 'R', 'S', 'L', 'T' });
+	BufferAppend::LittleEndian(m_buffer, 1, 4); //version
+	appendBinaryText(solver);
+	BufferAppend::LittleEndian(m_buffer, parameters.size(), 4);
+	for (auto& parameter : parameters)
+	{
+		appendBinaryText(parameter.Name);
+		appendBinaryText(parameter.Value);
+	}
+	return flushBuffer();
+}
+
+bool ResultWriter::Write(const RunRecord& record)
+{
+	if (m_format == ResultFormat::None)
+		return true;
+
+	if (m_format == ResultFormat::JsonLines)
+	{
+		auto appendKey = [this](const char* key)
+		{
+			m_buffer.push_back(',');
+			appendJsonString(key);
+			m_buffer.push_back(':');
+		};
+		m_buffer.insert(m_buffer.end(), m_jsonPrefix.begin(), m_jsonPrefix.end());
+		appendJsonString("run");
+		m_buffer.push_back(':');
+		BufferAppend::Number(m_buffer, record.Run);
+		appendKey("seed");
+		BufferAppend::UnsignedNumber(m_buffer, record.Seed);
+		appendKey("solved");
+		const char* solved = record.Solved ? "true" : "false";
+		m_buffer.insert(m_buffer.end(), solved, solved + std::strlen(solved));
+		appendKey("iterations");
+		BufferAppend::Number(m_buffer, record.Iterations);
+		appendKey("evaluations");
+		BufferAppend::Number(m_buffer, record.Evaluations);
+		appendKey("seconds");
+		appendDouble(record.Seconds);
+		appendKey("fitness");
+		appendDouble(record.Fitness);
+		appendKey("genome");
+		m_buffer.push_back('[');
+		for (int i = 0; i < record.Genome.size(); ++i)
+		{
+			if (i > 0)
+				m_buffer.push_back(',');
+			BufferAppend::Number(m_buffer, record.Genome[i]);
+		}
+		m_buffer.insert(m_buffer.end(), { ']', '}', '\n' });
+	}
+	else
+	{
+		unsigned long long seconds, fitness;
+		std::memcpy(&seconds, &record.Seconds, sizeof(seconds));
+		std::memcpy(&fitness, &record.Fitness, sizeof(fitness));
+		BufferAppend::LittleEndian(m_buffer, static_cast<unsigned>(record.Run), 4);
+		BufferAppend::LittleEndian(m_buffer, record.Seed, 8);
+		BufferAppend::LittleEndian(m_buffer, record.Solved ? 1 : 0, 1);
+		BufferAppend::LittleEndian(m_buffer, static_cast<unsigned long long>(record.Iterations), 8);
+		BufferAppend::LittleEndian(m_buffer, static_cast<unsigned long long>(record.Evaluations), 8);
+		BufferAppend::LittleEndian(m_buffer, seconds, 8);
+		BufferAppend::LittleEndian(m_buffer, fitness, 8);
+		BufferAppend::LittleEndian(m_buffer, record.Genome.size(), 4);
+		for (int gene : record.Genome)
+			BufferAppend::LittleEndian(m_buffer, static_cast<unsigned>(gene), 4);
+	}
+
+	if (m_buffer.size() >= m_bufferCapacity)
+		return flushBuffer();
+	return true;
+}
+
+bool ResultWriter::Close()
+{
+	if (m_format == ResultFormat::None)
+		return true;
+
+	bool success = flushBuffer();
+	m_file.close();
+	m_format = ResultFormat::None;
+	return success;
+}
+
+void ResultWriter::appendJsonString(const std::string& text)
+{
+	m_buffer.push_back('"');
+	for (char character : text)
+	{
+		if (character == '"' || character == '\\')
+		{
+			m_buffer.push_back('\\');
+			m_buffer.push_back(character);
+		}
+		else if (static_cast<unsigned char>(character) < 0x20)
+		{
+			char escaped[8];
+			int length = std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(character));
+			m_buffer.insert(m_buffer.end(), escaped, escaped + length);
+		}
+		else
+			m_buffer.push_back(character);
+	}
+	m_buffer.push_back('"');
+}
+
+void ResultWriter::appendDouble(const double& number)
+{
+	//JSON knows no infinity or NaN
+	if (!std::isfinite(number))
+	{
+		m_buffer.insert(m_buffer.end(), { 'n', 'u', 'l', 'l' });
+		return;
+	}
+	//17 significant digits read back as the same double
+	char text[32];
+	int length = std::snprintf(text, sizeof(text), "%.17g", number);
+	m_buffer.insert(m_buffer.end(), text, text + length);
+}
+
+void ResultWriter::appendBinaryText(const std::string& text)
+{
+	BufferAppend::LittleEndian(m_buffer, text.size(), 4);
+	m_buffer.insert(m_buffer.end(), text.begin(), text.end());
+}
+
+bool ResultWriter::flushBuffer()
+{
+	m_file.write(m_buffer.data(), m_buffer.size());
+	m_buffer.clear();
+	if (!m_file.good())
+	{
+		std::cerr << "ERROR: Could not write file '" << m_path << "'!\n";
+		return false;
+	}
+	return true;
+}
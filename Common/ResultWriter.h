@@ -0,0 +1,76 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+
+namespace ResultFormat
+{
+	enum Enum
+	{
+		None,
+		JsonLines, //one JSON object per run and line, every line repeats the solver and the parameters
+		Binary //"RSLT", the header with the solver and the parameters once, then one record per run, little endian
+	};
+
+	const char* GetFileExtension(const Enum& format);
+}
+
+//parameters of the solver, the same for all runs of one file
+struct RunParameter
+{
+	std::string Name;
+	std::string Value; //as text, numbers are written unquoted into JSON
+	bool IsNumber;
+
+	static RunParameter Text(const std::string& name, const std::string& value) { return RunParameter{ name, value, false }; }
+	template<typename T>
+	static RunParameter Number(const std::string& name, const T& value)
+	{
+		std::ostringstream text;
+		text << value;
+		return RunParameter{ name, text.str(), true };
+	}
+};
+
+//everything about one run, the seed and the parameters reproduce it
+struct RunRecord
+{
+	int Run = 0;
+	unsigned long long Seed = 0;
+	bool Solved = false;
+	long long Iterations = 0;
+	long long Evaluations = 0;
+	double Seconds = 0;
+	double Fitness = 0; //best fitness or quality at the end of the run
+	std::vector<int> Genome; //of the best individual, empty if the solver only keeps solutions and found none
+};
+
+//writes one record per run, which pipelines read without parsing the console output
+//binary layout: "RSLT", version (int32), solver, parameters amount (uint32) and the name and value of every parameter, all texts with a uint32 length prefix
+//every record: run (int32), seed (uint64), solved (uint8), iterations and evaluations (int64), seconds and fitness (float64), genes amount (uint32) and genes (int32)
+class ResultWriter
+{
+public:
+	ResultWriter();
+	~ResultWriter();
+
+	bool Open(const std::string& path, const ResultFormat::Enum& format, const std::string& solver, const std::vector<RunParameter>& parameters);
+	//not thread safe, the runs of a batch write through one export queue
+	bool Write(const RunRecord& record);
+	bool Close();
+
+private:
+	void appendJsonString(const std::string& text);
+	void appendDouble(const double& number);
+	void appendBinaryText(const std::string& text);
+	bool flushBuffer();
+
+	static const size_t m_bufferCapacity = 1 << 20;
+
+	ResultFormat::Enum m_format = ResultFormat::None;
+	std::string m_path;
+	std::ofstream m_file;
+	std::vector<char> m_buffer;
+	std::string m_jsonPrefix; //"{"solver":..,"parameters":{..}," of every line
+};
@@ -0,0 +1,129 @@
+#include "Telemetry.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+const char* TelemetryPhase::ToString(const Enum& phase)
+{
+	switch (phase)
+	{
+	case Initialization: return "initialization";
+	case Evaluation: return "evaluation";
+	case Crossover: return "crossover";
+	case Mutation: return "mutation";
+	case Selection: return "selection";
+	case IO: return "io";
+	default: return "unknown";
+	}
+}
+
+const char* TelemetryCounter::ToString(const Enum& counter)
+{
+	switch (counter)
+	{
+	case FitnessEvaluations: return "evaluations";
+	case CachedFitnessHits: return "cached";
+	case Copies: return "copies";
+	case Allocations: return "allocations";
+	default: return "unknown";
+	}
+}
+
+Telemetry::Telemetry()
+{
+	Reset();
+}
+
+Telemetry::Telemetry(const Telemetry& other)
+{
+	*this = other;
+}
+
+Telemetry& Telemetry::operator=(const Telemetry& other)
+{
+	if (this == &other)
+		return *this;
+
+	m_generation = other.m_generation.load();
+	for (int phase = 0; phase < TelemetryPhase::Amount; ++phase)
+		m_phaseNanoseconds[phase] = other.m_phaseNanoseconds[phase].load();
+	for (int counter = 0; counter < TelemetryCounter::Amount; ++counter)
+		m_counters[counter] = other.m_counters[counter].load();
+	m_observer = other.m_observer;
+	return *this;
+}
+
+void Telemetry::SetObserver(const Observer& observer)
+{
+	m_observer = observer;
+}
+
+void Telemetry::Reset()
+{
+	m_generation = 0;
+	for (auto& nanoseconds : m_phaseNanoseconds)
+		nanoseconds = 0;
+	for (auto& counter : m_counters)
+		counter = 0;
+}
+
+void Telemetry::AddTime(const TelemetryPhase::Enum& phase, const std::chrono::steady_clock::duration& duration)
+{
+	m_phaseNanoseconds[phase].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), std::memory_order_relaxed);
+}
+
+void Telemetry::Count(const TelemetryCounter::Enum& counter, const long long& amount)
+{
+	m_counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void Telemetry::EndGeneration()
+{
+	m_generation.fetch_add(1, std::memory_order_relaxed);
+	if (!m_observer)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_observerMutex);
+	m_observer(GetSnapshot());
+}
+
+void Telemetry::Add(const TelemetrySnapshot& snapshot)
+{
+	m_generation.fetch_add(snapshot.Generation, std::memory_order_relaxed);
+	for (int phase = 0; phase < TelemetryPhase::Amount; ++phase)
+		m_phaseNanoseconds[phase].fetch_add(std::llround(snapshot.PhaseSeconds[phase] * 1e9), std::memory_order_relaxed);
+	for (int counter = 0; counter < TelemetryCounter::Amount; ++counter)
+		m_counters[counter].fetch_add(snapshot.Counters[counter], std::memory_order_relaxed);
+}
+
+TelemetrySnapshot Telemetry::GetSnapshot() const
+{
+	TelemetrySnapshot snapshot;
+	snapshot.Generation = m_generation.load(std::memory_order_relaxed);
+	for (int phase = 0; phase < TelemetryPhase::Amount; ++phase)
+		snapshot.PhaseSeconds[phase] = m_phaseNanoseconds[phase].load(std::memory_order_relaxed) * 1e-9;
+	for (int counter = 0; counter < TelemetryCounter::Amount; ++counter)
+		snapshot.Counters[counter] = m_counters[counter].load(std::memory_order_relaxed);
+	return snapshot;
+}
+
+std::string Telemetry::FormatStatsLine(const TelemetrySnapshot& snapshot)
+{
+	std::ostringstream line;
+	line << "STATS: generation " << snapshot.Generation << std::fixed << std::setprecision(3);
+	for (int phase = 0; phase < TelemetryPhase::Amount; ++phase)
+		line << ", " << TelemetryPhase::ToString(static_cast<TelemetryPhase::Enum>(phase)) << " " << snapshot.PhaseSeconds[phase] << "s";
+	for (int counter = 0; counter < TelemetryCounter::Amount; ++counter)
+		line << ", " << TelemetryCounter::ToString(static_cast<TelemetryCounter::Enum>(counter)) << " " << snapshot.Counters[counter];
+	return line.str();
+}
+
+Telemetry::Observer Telemetry::CreateStatsLinePrinter(const int& interval)
+{
+	return [interval](const TelemetrySnapshot& snapshot)
+	{
+		if (snapshot.Generation % interval == 0)
+			std::cout << FormatStatsLine(snapshot) << "\n";
+	};
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace TelemetryPhase
+{
+	enum Enum
+	{
+		Initialization,
+		Evaluation,
+		Crossover, //recombination of the evolution strategies as well
+		Mutation,
+		Selection,
+		IO,
+		Amount
+	};
+
+	const char* ToString(const Enum& phase);
+}
+namespace TelemetryCounter
+{
+	enum Enum
+	{
+		FitnessEvaluations, //fitness computations, individuals with a known fitness are not counted
+		CachedFitnessHits, //individuals whose fitness was already known and didn't have to be computed
+		Copies, //individuals copied from one place to another
+		Allocations, //buffers which had to grow
+		Amount
+	};
+
+	const char* ToString(const Enum& counter);
+}
+
+//totals since the last reset
+struct TelemetrySnapshot
+{
+	long long Generation = 0;
+	double PhaseSeconds[TelemetryPhase::Amount] = {};
+	long long Counters[TelemetryCounter::Amount] = {};
+};
+
+//per phase timers and counters of a solver run, only recorded with SOLVER_TELEMETRY defined
+//without it the macros below are empty, nothing is measured and the observer is never called
+class Telemetry
+{
+public:
+	typedef std::function<void(const TelemetrySnapshot&)> Observer;
+
+	Telemetry();
+	Telemetry(const Telemetry& other);
+	Telemetry& operator=(const Telemetry& other);
+
+	static constexpr bool IsEnabled()
+	{
+#ifdef SOLVER_TELEMETRY
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	//observer(snapshot) is called after every generation, with islands from all island threads but never at the same time
+	void SetObserver(const Observer& observer);
+	void Reset();
+
+	//thread safe, the workers add their own share
+	void AddTime(const TelemetryPhase::Enum& phase, const std::chrono::steady_clock::duration& duration);
+	void Count(const TelemetryCounter::Enum& counter, const long long& amount);
+	void EndGeneration();
+	//adds the totals of another recording, e.g. of one run of a batch
+	void Add(const TelemetrySnapshot& snapshot);
+
+	TelemetrySnapshot GetSnapshot() const;
+	//one line with the seconds of every phase and all counters
+	static std::string FormatStatsLine(const TelemetrySnapshot& snapshot);
+	//observer which prints the stats line every interval generations
+	static Observer CreateStatsLinePrinter(const int& interval);
+
+	//resizes a buffer and returns 1 if it had to allocate, for the Allocations counter
+	template<typename Buffer>
+	static int ResizeBuffer(Buffer& buffer, const size_t& size)
+	{
+		int allocations = buffer.capacity() < size ? 1 : 0;
+		buffer.resize(size);
+		return allocations;
+	}
+
+private:
+	std::atomic<long long> m_generation;
+	std::atomic<long long> m_phaseNanoseconds[TelemetryPhase::Amount];
+	std::atomic<long long> m_counters[TelemetryCounter::Amount];
+	Observer m_observer;
+	std::mutex m_observerMutex;
+};
+
+//measures the time until the end of its scope
+class TelemetryPhaseTimer
+{
+public:
+	TelemetryPhaseTimer(Telemetry* telemetry, const TelemetryPhase::Enum& phase) : m_telemetry(telemetry), m_phase(phase)
+	{
+		if (m_telemetry)
+			m_startTime = std::chrono::steady_clock::now();
+	}
+
+	~TelemetryPhaseTimer()
+	{
+		if (m_telemetry)
+			m_telemetry->AddTime(m_phase, std::chrono::steady_clock::now() - m_startTime);
+	}
+
+private:
+	Telemetry* m_telemetry;
+	TelemetryPhase::Enum m_phase;
+	std::chrono::steady_clock::time_point m_startTime;
+};
+
+//the telemetry argument is a Telemetry*, nullptr records nothing
+#ifdef SOLVER_TELEMETRY
+#define TELEMETRY_CONCAT_IMPL(left, right) left##right
+#define TELEMETRY_CONCAT(left, right) TELEMETRY_CONCAT_IMPL(left, right)
+#define TELEMETRY_PHASE(telemetry, phase) TelemetryPhaseTimer TELEMETRY_CONCAT(telemetryPhaseTimer, __LINE__)(telemetry, phase)
+#define TELEMETRY_COUNT(telemetry, counter, amount) do { if (telemetry) (telemetry)->Count(counter, amount); } while (false)
+#define TELEMETRY_END_GENERATION(telemetry) do { if (telemetry) (telemetry)->EndGeneration(); } while (false)
+#else
+#define TELEMETRY_PHASE(telemetry, phase) ((void)0)
+#define TELEMETRY_COUNT(telemetry, counter, amount) ((void)0)
+#define TELEMETRY_END_GENERATION(telemetry) ((void)0)
+#endif
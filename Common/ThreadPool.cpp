@@ -0,0 +1,98 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(const int& threadsAmount)
+{
+	for (int workerIndex = 1; workerIndex < threadsAmount; ++workerIndex)
+		m_threads.emplace_back(&ThreadPool::workerLoop, this, workerIndex);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_shutdown = true;
+	}
+	m_taskCondition.notify_all();
+
+	for (auto& thread : m_threads)
+		thread.join();
+}
+
+int ThreadPool::GetThreadsAmount() const
+{
+	return static_cast<int>(m_threads.size()) + 1;
+}
+
+void ThreadPool::run(const void* task, TaskInvoker invoker)
+{
+	if (m_threads.empty())
+	{
+		invoker(task, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_task = task;
+		m_taskInvoker = invoker;
+		m_pendingWorkers = static_cast<int>(m_threads.size());
+		++m_taskGeneration;
+	}
+	m_taskCondition.notify_all();
+
+	invoker(task, 0);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_doneCondition.wait(lock, [this] { return m_pendingWorkers == 0; });
+	m_task = nullptr;
+}
+
+void ThreadPool::GetWorkerRange(const int& workerIndex, const int& workersAmount, const int& amount, const int& alignment, int& outBegin, int& outEnd)
+{
+	int blocks = (amount + alignment - 1) / alignment;
+	int blocksPerWorker = blocks / workersAmount;
+	int remainingBlocks = blocks % workersAmount;
+
+	//the first workers take one of the remaining blocks each
+	int firstBlock = workerIndex * blocksPerWorker + std::min(workerIndex, remainingBlocks);
+	int lastBlock = firstBlock + blocksPerWorker + (workerIndex < remainingBlocks ? 1 : 0);
+
+	outBegin = std::min(firstBlock * alignment, amount);
+	outEnd = std::min(lastBlock * alignment, amount);
+}
+
+int ThreadPool::ResolveThreadsAmount(const int& requestedThreadsAmount)
+{
+	if (requestedThreadsAmount > 0)
+		return requestedThreadsAmount;
+	int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+	return hardwareThreads > 0 ? hardwareThreads : 1;
+}
+
+void ThreadPool::workerLoop(const int& workerIndex)
+{
+	unsigned lastTaskGeneration = 0;
+	while (true)
+	{
+		const void* task;
+		TaskInvoker invoker;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_taskCondition.wait(lock, [this, &lastTaskGeneration] { return m_shutdown || m_taskGeneration != lastTaskGeneration; });
+			if (m_shutdown)
+				return;
+			lastTaskGeneration = m_taskGeneration;
+			task = m_task;
+			invoker = m_taskInvoker;
+		}
+
+		invoker(task, workerIndex);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			--m_pendingWorkers;
+		}
+		m_doneCondition.notify_one();
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//fixed amount of workers which execute the same task in parallel, the calling thread is always worker 0
+class ThreadPool
+{
+public:
+	explicit ThreadPool(const int& threadsAmount = 1);
+	~ThreadPool();
+
+	int GetThreadsAmount() const;
+
+	//runs task(workerIndex) once on every worker and blocks until all workers are finished, the task is never copied or allocated
+	template<typename Task>
+	void Run(const Task& task)
+	{
+		run(&task, [](const void* context, int workerIndex) { (*static_cast<const Task*>(context))(workerIndex); });
+	}
+
+	//splits [0, amount) into one contiguous range per worker, range borders are multiples of alignment
+	static void GetWorkerRange(const int& workerIndex, const int& workersAmount, const int& amount, const int& alignment, int& outBegin, int& outEnd);
+
+	//0 -> one thread per hardware thread
+	static int ResolveThreadsAmount(const int& requestedThreadsAmount);
+
+private:
+	typedef void(*TaskInvoker)(const void* context, int workerIndex);
+
+	void run(const void* task, TaskInvoker invoker);
+	void workerLoop(const int& workerIndex);
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_taskCondition;
+	std::condition_variable m_doneCondition;
+	const void* m_task = nullptr;
+	TaskInvoker m_taskInvoker = nullptr;
+	unsigned m_taskGeneration = 0;
+	int m_pendingWorkers = 0;
+	bool m_shutdown = false;
+};
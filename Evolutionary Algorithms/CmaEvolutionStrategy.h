@@ -0,0 +1,331 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include "../Common/RandomEngine.h"
+#include "../Common/ThreadPool.h"
+#include "../Common/Telemetry.h"
+#include "EvolutionStrategy.h"
+#include "TopSelection.h"
+
+//CMA-ES after Hansen's tutorial, the search runs in real space and every sample is rounded to the gene type before the evaluation
+//the covariance matrix is updated every generation, its eigen decomposition only every few generations
+template<typename GenomeType, typename Objective, typename Constraint, typename Evaluator = ScalarEvaluator<GenomeType, Objective, Constraint>>
+class CmaEvolutionStrategy
+{
+public:
+	typedef typename GenomeType::GeneType Gene;
+	typedef typename Objective::Quality Quality;
+	static const int GenesAmount = GenomeType::Size;
+
+	struct Settings
+	{
+		int Lambda = 0; //0 -> 4 + 3 ln(n), mu is always lambda / 2
+		Gene IndividualRandomRange[2] = {}; //the start mean is drawn from it
+		double InitialStepSize = 1;
+		double MinStepSize = 0; //lower bound of the standard deviation of every gene, integer genes stop moving below one
+		int MaxIterations = 1000000;
+		Telemetry* Recorder = nullptr; //phases and counters of the run, nullptr records nothing
+	};
+
+	//the worker engines are only used to evaluate in parallel, all samples are drawn from the engine given to Evolve
+	CmaEvolutionStrategy(const Settings& settings, ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines, const Objective& objective = Objective(), const Constraint& constraint = Constraint())
+		: m_settings(settings), m_threadPool(threadPool), m_workerEngines(workerEngines), m_objective(objective), m_constraint(constraint)
+	{
+		const double n = GenesAmount;
+		m_lambda = m_settings.Lambda > 0 ? m_settings.Lambda : 4 + static_cast<int>(3 * std::log(n));
+		m_mu = std::max(m_lambda / 2, 1);
+
+		//log weights of the mu best, summing up to one
+		int allocations = Telemetry::ResizeBuffer(m_weights, m_mu);
+		double weightsSum = 0, squaredWeightsSum = 0;
+		for (int i = 0; i < m_mu; ++i)
+			weightsSum += m_weights[i] = std::log(m_mu + 0.5) - std::log(i + 1.0);
+		for (double& weight : m_weights)
+		{
+			weight /= weightsSum;
+			squaredWeightsSum += weight * weight;
+		}
+		m_muEffective = 1 / squaredWeightsSum;
+
+		m_stepSizeLearningRate = (m_muEffective + 2) / (n + m_muEffective + 5);
+		m_stepSizeDamping = 1 + 2 * std::max(0.0, std::sqrt((m_muEffective - 1) / (n + 1)) - 1) + m_stepSizeLearningRate;
+		m_pathLearningRate = (4 + m_muEffective / n) / (n + 4 + 2 * m_muEffective / n);
+		m_rankOneLearningRate = 2 / ((n + 1.3) * (n + 1.3) + m_muEffective);
+		m_rankMuLearningRate = std::min(1 - m_rankOneLearningRate, 2 * (m_muEffective - 2 + 1 / m_muEffective) / ((n + 2) * (n + 2) + m_muEffective));
+		m_expectedNormalLength = std::sqrt(n) * (1 - 1 / (4 * n) + 1 / (21 * n * n));
+		//the decomposition costs O(n^3), with this interval it stays below the O(n^2) per sample of the sampling itself
+		m_decompositionInterval = std::max(1, static_cast<int>(1 / ((m_rankOneLearningRate + m_rankMuLearningRate) * n * 10)));
+
+		for (auto& genes : m_genes)
+			allocations += Telemetry::ResizeBuffer(genes, m_lambda);
+		allocations += Telemetry::ResizeBuffer(m_qualities, m_lambda);
+		allocations += Telemetry::ResizeBuffer(m_steps, m_lambda * GenesAmount);
+		allocations += Telemetry::ResizeBuffer(m_workerSolutionIndices, m_threadPool.GetThreadsAmount());
+		TELEMETRY_COUNT(m_settings.Recorder, TelemetryCounter::Allocations, allocations);
+	}
+
+	//onGeneration(bestQuality) is called after every generation, returns true if a solution was found before the iterations ran out
+	template<typename GenerationCallback>
+	bool Evolve(RandomEngine& randomEngine, int& iterationCounter, GenomeType& outSolution, GenerationCallback onGeneration)
+	{
+		{
+			TELEMETRY_PHASE(m_settings.Recorder, TelemetryPhase::Initialization);
+			initializeDistribution(randomEngine);
+		}
+
+		/* -------------------------------------- START EVOLUTION -------------------------------------- */
+		for (; iterationCounter <= m_settings.MaxIterations; ++iterationCounter)
+		{
+			/* -------------------------------------- SAMPLING -------------------------------------- */
+			{
+				//sampling from the adapted distribution is the mutation of CMA-ES
+				TELEMETRY_PHASE(m_settings.Recorder, TelemetryPhase::Mutation);
+				if (iterationCounter % m_decompositionInterval == 0)
+					decomposeCovariance();
+				sampleGeneration(randomEngine);
+			}
+
+			/* -------------------------------------- SELECTION -------------------------------------- */
+			if (evaluateAndReturnTrueIfSolutionFound(outSolution))
+				return true;
+
+			{
+				TELEMETRY_PHASE(m_settings.Recorder, TelemetryPhase::Selection);
+				if (m_threadPool.GetThreadsAmount() > 1)
+					m_selection.SelectParallel(m_qualities.data(), m_lambda, m_mu, m_threadPool, m_workerEngines, m_selectedIndices);
+				else
+					m_selection.Select(m_qualities.data(), m_lambda, m_mu, randomEngine, m_selectedIndices);
+
+				/* -------------------------------------- ADAPTATION -------------------------------------- */
+				updateDistribution(iterationCounter);
+			}
+
+			onGeneration(m_qualities[m_selectedIndices[0]]);
+			TELEMETRY_END_GENERATION(m_settings.Recorder);
+		}
+		return false;
+	}
+
+	long long GetEvaluationsAmount() const { return m_evaluationsAmount; }
+
+private:
+	//the rounding layer, samples far outside of the int range are clamped
+	static void toGene(const double& value, int& outGene) { outGene = static_cast<int>(std::lround(std::max(-1e9, std::min(1e9, value)))); }
+	static void toGene(const double& value, double& outGene) { outGene = value; }
+
+	void initializeDistribution(RandomEngine& randomEngine)
+	{
+		for (int i = 0; i < GenesAmount; ++i)
+		{
+			m_mean[i] = Random::Real(randomEngine, m_settings.IndividualRandomRange[0], m_settings.IndividualRandomRange[1]);
+			m_stepSizePath[i] = m_covariancePath[i] = 0;
+			m_axisLengths[i] = 1;
+			for (int j = 0; j < GenesAmount; ++j)
+				m_covariance[i][j] = m_axes[i][j] = i == j ? 1 : 0;
+		}
+		m_stepSize = m_settings.InitialStepSize;
+		m_evaluationsAmount = 0;
+	}
+
+	//x = mean + stepSize * B * D * z
+	void sampleGeneration(RandomEngine& randomEngine)
+	{
+		Random::FillNormals(m_steps.data(), m_lambda * GenesAmount, randomEngine);
+		for (int k = 0; k < m_lambda; ++k)
+		{
+			double* step = m_steps.data() + k * GenesAmount;
+			double scaled[GenesAmount];
+			for (int j = 0; j < GenesAmount; ++j)
+				scaled[j] = m_axisLengths[j] * step[j];
+			for (int i = 0; i < GenesAmount; ++i)
+			{
+				double value = 0;
+				for (int j = 0; j < GenesAmount; ++j)
+					value += m_axes[i][j] * scaled[j];
+				step[i] = value; //y = B * D * z is needed again for the covariance update
+			}
+			for (int i = 0; i < GenesAmount; ++i)
+				toGene(m_mean[i] + m_stepSize * step[i], m_genes[i][k]);
+		}
+	}
+
+	bool evaluateAndReturnTrueIfSolutionFound(GenomeType& outSolution)
+	{
+		TELEMETRY_PHASE(m_settings.Recorder, TelemetryPhase::Evaluation);
+		const Gene* genes[GenesAmount];
+		for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+			genes[geneIndex] = m_genes[geneIndex].data();
+
+		int solutionIndex = ParallelEvaluator<GenomeType, Objective, Constraint, Evaluator>::Evaluate(genes, m_qualities.data(), 0, m_lambda, m_objective, m_constraint, m_threadPool, m_workerSolutionIndices);
+		m_evaluationsAmount += m_lambda;
+		TELEMETRY_COUNT(m_settings.Recorder, TelemetryCounter::FitnessEvaluations, m_lambda);
+
+		if (solutionIndex < 0)
+			return false;
+		for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+			outSolution.Genes[geneIndex] = m_genes[geneIndex][solutionIndex];
+		return true;
+	}
+
+	void updateDistribution(const int& iterationCounter)
+	{
+		const double n = GenesAmount;
+
+		//weighted mean of the selected steps, the real valued samples are used and not the rounded genes
+		double meanStep[GenesAmount] = {};
+		for (int i = 0; i < m_mu; ++i)
+		{
+			const double* step = m_steps.data() + m_selectedIndices[i] * GenesAmount;
+			for (int j = 0; j < GenesAmount; ++j)
+				meanStep[j] += m_weights[i] * step[j];
+		}
+		for (int j = 0; j < GenesAmount; ++j)
+			m_mean[j] += m_stepSize * meanStep[j];
+
+		//step size path with C^-1/2 * meanStep = B * D^-1 * B^T * meanStep
+		double rotated[GenesAmount];
+		for (int j = 0; j < GenesAmount; ++j)
+		{
+			double value = 0;
+			for (int i = 0; i < GenesAmount; ++i)
+				value += m_axes[i][j] * meanStep[i];
+			rotated[j] = value / m_axisLengths[j];
+		}
+		double stepSizePathFactor = std::sqrt(m_stepSizeLearningRate * (2 - m_stepSizeLearningRate) * m_muEffective);
+		double stepSizePathLength = 0;
+		for (int i = 0; i < GenesAmount; ++i)
+		{
+			double value = 0;
+			for (int j = 0; j < GenesAmount; ++j)
+				value += m_axes[i][j] * rotated[j];
+			m_stepSizePath[i] = (1 - m_stepSizeLearningRate) * m_stepSizePath[i] + stepSizePathFactor * value;
+			stepSizePathLength += m_stepSizePath[i] * m_stepSizePath[i];
+		}
+		stepSizePathLength = std::sqrt(stepSizePathLength);
+
+		//the covariance path stalls while the step size path is long, so a quickly growing step size doesn't inflate the covariance as well
+		double pathNormalization = std::sqrt(1 - std::pow(1 - m_stepSizeLearningRate, 2.0 * (iterationCounter + 1)));
+		bool stalled = stepSizePathLength / pathNormalization >= (1.4 + 2 / (n + 1)) * m_expectedNormalLength;
+		double covariancePathFactor = stalled ? 0 : std::sqrt(m_pathLearningRate * (2 - m_pathLearningRate) * m_muEffective);
+		for (int i = 0; i < GenesAmount; ++i)
+			m_covariancePath[i] = (1 - m_pathLearningRate) * m_covariancePath[i] + covariancePathFactor * meanStep[i];
+
+		//rank one and rank mu update, only the upper triangle is computed
+		double oldFactor = 1 - m_rankOneLearningRate - m_rankMuLearningRate + (stalled ? m_rankOneLearningRate * m_pathLearningRate * (2 - m_pathLearningRate) : 0);
+		for (int i = 0; i < GenesAmount; ++i)
+		{
+			for (int j = i; j < GenesAmount; ++j)
+			{
+				double rankMu = 0;
+				for (int k = 0; k < m_mu; ++k)
+				{
+					const double* step = m_steps.data() + m_selectedIndices[k] * GenesAmount;
+					rankMu += m_weights[k] * step[i] * step[j];
+				}
+				m_covariance[i][j] = oldFactor * m_covariance[i][j] + m_rankOneLearningRate * m_covariancePath[i] * m_covariancePath[j] + m_rankMuLearningRate * rankMu;
+				m_covariance[j][i] = m_covariance[i][j];
+			}
+		}
+
+		m_stepSize *= std::exp((m_stepSizeLearningRate / m_stepSizeDamping) * (stepSizePathLength / m_expectedNormalLength - 1));
+
+		//every gene keeps at least the minimum standard deviation
+		double minVariance = m_covariance[0][0];
+		for (int i = 1; i < GenesAmount; ++i)
+			minVariance = std::min(minVariance, m_covariance[i][i]);
+		if (minVariance > 0)
+			m_stepSize = std::max(m_stepSize, m_settings.MinStepSize / std::sqrt(minVariance));
+	}
+
+	//cyclic Jacobi rotations, exact enough and simple for the small matrices of a genome
+	void decomposeCovariance()
+	{
+		double matrix[GenesAmount][GenesAmount];
+		for (int i = 0; i < GenesAmount; ++i)
+			for (int j = 0; j < GenesAmount; ++j)
+			{
+				matrix[i][j] = m_covariance[i][j];
+				m_axes[i][j] = i == j ? 1 : 0;
+			}
+
+		for (int sweep = 0; sweep < 50; ++sweep)
+		{
+			double offDiagonal = 0;
+			for (int p = 0; p < GenesAmount; ++p)
+				for (int q = p + 1; q < GenesAmount; ++q)
+					offDiagonal += matrix[p][q] * matrix[p][q];
+			if (offDiagonal < 1e-30)
+				break;
+
+			for (int p = 0; p < GenesAmount; ++p)
+			{
+				for (int q = p + 1; q < GenesAmount; ++q)
+				{
+					if (matrix[p][q] == 0)
+						continue;
+					double theta = (matrix[q][q] - matrix[p][p]) / (2 * matrix[p][q]);
+					double t = (theta >= 0 ? 1 : -1) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+					double c = 1 / std::sqrt(t * t + 1), s = t * c;
+					for (int k = 0; k < GenesAmount; ++k)
+					{
+						double kp = matrix[k][p], kq = matrix[k][q];
+						matrix[k][p] = c * kp - s * kq;
+						matrix[k][q] = s * kp + c * kq;
+					}
+					for (int k = 0; k < GenesAmount; ++k)
+					{
+						double pk = matrix[p][k], qk = matrix[q][k];
+						matrix[p][k] = c * pk - s * qk;
+						matrix[q][k] = s * pk + c * qk;
+					}
+					for (int k = 0; k < GenesAmount; ++k)
+					{
+						double kp = m_axes[k][p], kq = m_axes[k][q];
+						m_axes[k][p] = c * kp - s * kq;
+						m_axes[k][q] = s * kp + c * kq;
+					}
+				}
+			}
+		}
+
+		//rounding errors can leave tiny negative eigenvalues
+		for (int i = 0; i < GenesAmount; ++i)
+			m_axisLengths[i] = std::sqrt(std::max(matrix[i][i], 1e-20));
+	}
+
+	Settings m_settings;
+	ThreadPool& m_threadPool;
+	std::vector<RandomEngine>& m_workerEngines;
+	Objective m_objective;
+	Constraint m_constraint;
+
+	int m_lambda;
+	int m_mu;
+	std::vector<double> m_weights;
+	double m_muEffective;
+	double m_stepSizeLearningRate;
+	double m_stepSizeDamping;
+	double m_pathLearningRate;
+	double m_rankOneLearningRate;
+	double m_rankMuLearningRate;
+	double m_expectedNormalLength; //E|N(0, I)|
+	int m_decompositionInterval;
+
+	double m_mean[GenesAmount];
+	double m_stepSize;
+	double m_stepSizePath[GenesAmount];
+	double m_covariancePath[GenesAmount];
+	double m_covariance[GenesAmount][GenesAmount];
+	double m_axes[GenesAmount][GenesAmount]; //eigenvectors of the covariance as columns -> B
+	double m_axisLengths[GenesAmount]; //square roots of the eigenvalues -> D
+
+	std::vector<Gene> m_genes[GenesAmount]; //rounded samples in structure of arrays form for the evaluator
+	std::vector<Quality> m_qualities;
+	std::vector<double> m_steps; //z while sampling, y = B * D * z afterwards
+	std::vector<int> m_workerSolutionIndices;
+	TopSelection m_selection;
+	std::vector<int> m_selectedIndices;
+	long long m_evaluationsAmount = 0;
+};
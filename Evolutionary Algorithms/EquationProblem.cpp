@@ -0,0 +1,174 @@
+#include "EquationProblem.h"
+#include <climits>
+#include <cstdlib>
+#include <initializer_list>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+#if defined(__AVX2__) || defined(__AVX512F__)
+	int getLowestSetBit(const int& mask)
+	{
+		int bit = 0;
+		while (!(mask & (1 << bit)))
+			++bit;
+		return bit;
+	}
+#endif
+
+	int evaluateScalar(const int* x, const int* y, const int* a, const int* b, int* outQuality, const int& begin, const int& end)
+	{
+		int solution = -1;
+		for (int i = begin; i < end; ++i)
+		{
+			int quality = EquationObjective::GetQuality(x[i], y[i], a[i], b[i]);
+			bool usable = a[i] > b[i];
+			outQuality[i] = usable ? quality : INT_MAX;
+			if (usable && quality == 0 && solution < 0)
+				solution = i;
+		}
+		return solution;
+	}
+
+#if defined(__AVX512F__)
+	//quality of 8 individuals in 64 bit lanes, the lanes outside of the domain are garbage and have to be masked by the caller
+	__m512i getQualityAvx512(const __m256i& x, const __m256i& y, const __m256i& a, const __m256i& b)
+	{
+		__m512i vx = _mm512_cvtepi32_epi64(x), vy = _mm512_cvtepi32_epi64(y), va = _mm512_cvtepi32_epi64(a), vb = _mm512_cvtepi32_epi64(b);
+		__m512i x2 = _mm512_mul_epi32(vx, vx), y2 = _mm512_mul_epi32(vy, vy), b2 = _mm512_mul_epi32(vb, vb);
+		//y^2 has up to 40 bits, its two 20 bit halves are multiplied with y on their own
+		const __m512i lowBits = _mm512_set1_epi64((1 << 20) - 1);
+		__m512i y3 = _mm512_add_epi64(_mm512_slli_epi64(_mm512_mul_epi32(_mm512_srli_epi64(y2, 20), vy), 20), _mm512_mul_epi32(_mm512_and_si512(y2, lowBits), vy));
+		__m512i left = _mm512_add_epi64(_mm512_add_epi64(x2, _mm512_slli_epi64(x2, 1)), _mm512_add_epi64(y3, _mm512_slli_epi64(y3, 2)));
+		__m512i right = _mm512_add_epi64(_mm512_mul_epi32(va, _mm512_set1_epi64(7)), _mm512_add_epi64(b2, _mm512_slli_epi64(b2, 1)));
+		return _mm512_min_epi64(_mm512_abs_epi64(_mm512_sub_epi64(left, right)), _mm512_set1_epi64(INT_MAX));
+	}
+
+	int evaluateAvx512(const int* x, const int* y, const int* a, const int* b, int* outQuality, const int& begin, const int& end, int& outEnd)
+	{
+		const __m512i maxGene = _mm512_set1_epi32(EquationObjective::MaxGeneMagnitude), minGene = _mm512_set1_epi32(-EquationObjective::MaxGeneMagnitude), unusable = _mm512_set1_epi32(INT_MAX);
+		int solution = -1;
+		int i = begin;
+		for (; i + 16 <= end; i += 16)
+		{
+			__m512i vx = _mm512_loadu_si512(x + i), vy = _mm512_loadu_si512(y + i), va = _mm512_loadu_si512(a + i), vb = _mm512_loadu_si512(b + i);
+			__mmask16 inDomain = 0xFFFF;
+			for (const __m512i& gene : { vx, vy, va, vb })
+				inDomain &= _mm512_cmple_epi32_mask(gene, maxGene) & _mm512_cmpge_epi32_mask(gene, minGene);
+
+			//the 64 bit qualities of both halves are at most INT_MAX and get narrowed back to 32 bit
+			__m256i lowQuality = _mm512_cvtepi64_epi32(getQualityAvx512(_mm512_castsi512_si256(vx), _mm512_castsi512_si256(vy), _mm512_castsi512_si256(va), _mm512_castsi512_si256(vb)));
+			__m256i highQuality = _mm512_cvtepi64_epi32(getQualityAvx512(_mm512_extracti64x4_epi64(vx, 1), _mm512_extracti64x4_epi64(vy, 1), _mm512_extracti64x4_epi64(va, 1), _mm512_extracti64x4_epi64(vb, 1)));
+			__m512i quality = _mm512_inserti64x4(_mm512_castsi256_si512(lowQuality), highQuality, 1);
+
+			__mmask16 usable = _mm512_cmpgt_epi32_mask(va, vb) & inDomain;
+			_mm512_storeu_si512(outQuality + i, _mm512_mask_blend_epi32(usable, unusable, quality));
+
+			__mmask16 solved = _mm512_mask_cmpeq_epi32_mask(usable, quality, _mm512_setzero_si512());
+			if (solved && solution < 0)
+				solution = i + getLowestSetBit(solved);
+		}
+		outEnd = i;
+		return solution;
+	}
+#endif
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+	//quality of 4 individuals in 64 bit lanes, the lanes outside of the domain are garbage and have to be masked by the caller
+	__m256i getQualityAvx2(const __m128i& x, const __m128i& y, const __m128i& a, const __m128i& b)
+	{
+		__m256i vx = _mm256_cvtepi32_epi64(x), vy = _mm256_cvtepi32_epi64(y), va = _mm256_cvtepi32_epi64(a), vb = _mm256_cvtepi32_epi64(b);
+		__m256i x2 = _mm256_mul_epi32(vx, vx), y2 = _mm256_mul_epi32(vy, vy), b2 = _mm256_mul_epi32(vb, vb);
+		//y^2 has up to 40 bits, its two 20 bit halves are multiplied with y on their own
+		const __m256i lowBits = _mm256_set1_epi64x((1 << 20) - 1);
+		__m256i y3 = _mm256_add_epi64(_mm256_slli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(y2, 20), vy), 20), _mm256_mul_epi32(_mm256_and_si256(y2, lowBits), vy));
+		__m256i left = _mm256_add_epi64(_mm256_add_epi64(x2, _mm256_slli_epi64(x2, 1)), _mm256_add_epi64(y3, _mm256_slli_epi64(y3, 2)));
+		__m256i right = _mm256_add_epi64(_mm256_mul_epi32(va, _mm256_set1_epi64x(7)), _mm256_add_epi64(b2, _mm256_slli_epi64(b2, 1)));
+		__m256i difference = _mm256_sub_epi64(left, right);
+
+		//there is neither an abs nor a min for 64 bit lanes in AVX2
+		__m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), difference);
+		__m256i absolute = _mm256_sub_epi64(_mm256_xor_si256(difference, negative), negative);
+		const __m256i saturation = _mm256_set1_epi64x(INT_MAX);
+		return _mm256_blendv_epi8(absolute, saturation, _mm256_cmpgt_epi64(absolute, saturation));
+	}
+
+	int evaluateAvx2(const int* x, const int* y, const int* a, const int* b, int* outQuality, const int& begin, const int& end, int& outEnd)
+	{
+		const __m256i maxGene = _mm256_set1_epi32(EquationObjective::MaxGeneMagnitude), minGene = _mm256_set1_epi32(-EquationObjective::MaxGeneMagnitude), unusable = _mm256_set1_epi32(INT_MAX);
+		//picks the low halves of the 64 bit lanes
+		const __m256i narrowing = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+		int solution = -1;
+		int i = begin;
+		for (; i + 8 <= end; i += 8)
+		{
+			__m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)), vy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+			__m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+			__m256i outOfDomain = _mm256_setzero_si256();
+			for (const __m256i& gene : { vx, vy, va, vb })
+				outOfDomain = _mm256_or_si256(outOfDomain, _mm256_or_si256(_mm256_cmpgt_epi32(gene, maxGene), _mm256_cmpgt_epi32(minGene, gene)));
+
+			//the 64 bit qualities of both halves are at most INT_MAX and get narrowed back to 32 bit
+			__m128i lowQuality = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(getQualityAvx2(_mm256_castsi256_si128(vx), _mm256_castsi256_si128(vy), _mm256_castsi256_si128(va), _mm256_castsi256_si128(vb)), narrowing));
+			__m128i highQuality = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(getQualityAvx2(_mm256_extracti128_si256(vx, 1), _mm256_extracti128_si256(vy, 1), _mm256_extracti128_si256(va, 1), _mm256_extracti128_si256(vb, 1)), narrowing));
+			__m256i quality = _mm256_inserti128_si256(_mm256_castsi128_si256(lowQuality), highQuality, 1);
+
+			__m256i usable = _mm256_andnot_si256(outOfDomain, _mm256_cmpgt_epi32(va, vb)); //all bits set per usable lane
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(outQuality + i), _mm256_blendv_epi8(unusable, quality, usable));
+
+			int solvedMask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(usable, _mm256_cmpeq_epi32(quality, _mm256_setzero_si256()))));
+			if (solvedMask && solution < 0)
+				solution = i + getLowestSetBit(solvedMask);
+		}
+		outEnd = i;
+		return solution;
+	}
+#endif
+}
+
+const int EquationObjective::MaxGeneMagnitude;
+
+int EquationObjective::operator()(const int (&genes)[EquationGenome::Size]) const
+{
+	return GetQuality(genes[0], genes[1], genes[2], genes[3]);
+}
+
+bool EquationObjective::IsInDomain(const int& x, const int& y, const int& a, const int& b)
+{
+	for (int gene : { x, y, a, b })
+		if (gene < -MaxGeneMagnitude || gene > MaxGeneMagnitude)
+			return false;
+	return true;
+}
+
+long long EquationObjective::GetDifference(const int& x, const int& y, const int& a, const int& b)
+{
+	//5y^3 is the largest term with at most 5 * 2^60
+	long long left = 3LL * x * x + 5LL * y * y * y;
+	long long right = 7LL * a + 3LL * b * b;
+	return left - right;
+}
+
+int EquationObjective::GetQuality(const int& x, const int& y, const int& a, const int& b)
+{
+	if (!IsInDomain(x, y, a, b))
+		return INT_MAX;
+	long long difference = std::llabs(GetDifference(x, y, a, b));
+	return difference < INT_MAX ? static_cast<int>(difference) : INT_MAX;
+}
+
+int EquationEvaluator::Evaluate(const int* const* genes, int* outQualities, const int& begin, const int& end, const EquationObjective&, const EquationConstraint&)
+{
+	int vectorizedEnd = begin;
+	int solution = -1;
+	//the vectorized paths leave the tail which doesn't fill a whole register to the scalar path
+#if defined(__AVX512F__)
+	solution = evaluateAvx512(genes[0], genes[1], genes[2], genes[3], outQualities, begin, end, vectorizedEnd);
+#elif defined(__AVX2__)
+	solution = evaluateAvx2(genes[0], genes[1], genes[2], genes[3], outQualities, begin, end, vectorizedEnd);
+#endif
+	int tailSolution = evaluateScalar(genes[0], genes[1], genes[2], genes[3], outQualities, vectorizedEnd, end);
+	return solution >= 0 ? solution : tailSolution;
+}
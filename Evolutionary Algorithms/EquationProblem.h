@@ -0,0 +1,44 @@
+#pragma once
+#include "EvolutionStrategy.h"
+#include "CmaEvolutionStrategy.h"
+#include <type_traits>
+
+typedef Genome<int, 4> EquationGenome; //x, y, a and b
+
+//condition 1 -> 3x^2 + 5y^3 = 7a + 3b^2
+struct EquationObjective
+{
+	typedef int Quality; //difference of both equation sides
+
+	//genes with a larger magnitude are outside of the search domain, in it every term of the equation fits into 64 bit
+	static const int MaxGeneMagnitude = 1 << 20;
+
+	int operator()(const int (&genes)[EquationGenome::Size]) const;
+	bool IsSolution(const int& quality) const { return quality == 0; }
+
+	static bool IsInDomain(const int& x, const int& y, const int& a, const int& b);
+	//3x^2 + 5y^3 - (7a + 3b^2) in 64 bit, the genes have to be in the domain
+	static long long GetDifference(const int& x, const int& y, const int& a, const int& b);
+	//absolute difference saturated to INT_MAX, INT_MAX outside of the domain as well, the reference for the vectorized paths
+	static int GetQuality(const int& x, const int& y, const int& a, const int& b);
+};
+
+//condition 2 -> a > b
+struct EquationConstraint
+{
+	bool operator()(const int (&genes)[EquationGenome::Size]) const { return genes[2] > genes[3]; }
+};
+
+//evaluates 8 (AVX2) or 16 (AVX-512) individuals per instruction
+//the vector paths are chosen at compile time (/arch:AVX2, /arch:AVX512), without them the scalar path is used
+//the objective and the constraint are built into the kernels, their parameters are only there for the evaluator interface of the strategies
+struct EquationEvaluator
+{
+	//quality of [begin, end), INT_MAX if condition 2 isn't fulfilled, returns the first index which fulfills both conditions or -1
+	static int Evaluate(const int* const* genes, int* outQualities, const int& begin, const int& end, const EquationObjective&, const EquationConstraint&);
+};
+//a state in the objective or the constraint would be ignored by the kernels
+static_assert(std::is_empty<EquationObjective>::value && std::is_empty<EquationConstraint>::value, "EquationEvaluator only supports the stateless equation and condition");
+
+typedef EvolutionStrategy<EquationGenome, EquationObjective, EquationConstraint, EquationEvaluator> EquationStrategy;
+typedef CmaEvolutionStrategy<EquationGenome, EquationObjective, EquationConstraint, EquationEvaluator> EquationCmaStrategy;
@@ -1,14 +1,15 @@
 ﻿#include "EquationSolver.h"
 #include <iostream>
-#include <fstream>
 #include <random>
 #include <string>
 #include <map>
 #include <algorithm>
+#include <cmath>
+#include <chrono>
+#include "../Common/ExportQueue.h"
 
-EquationSolver::EquationSolver()
+EquationSolver::EquationSolver() : m_seed(std::random_device()())
 {
-	m_mersenneTwisterEngine = std::mt19937_64(m_randomDevice());
 }
 
 EquationSolver::~EquationSolver()
@@ -20,25 +21,37 @@ int EquationSolver::Execute(int argc, char** argv)
 	if (!parseCommandLine(argc, argv))
 		return 0;
 
+	if (m_runsAmount > 1)
+	{
+		executeBatch();
+		return 1;
+	}
+
 	initializeRandomGenerators();
+	initializeWorkers();
+	executeEvolutionStrategy(getStrategyFunction());
+
+	return 1;
+}
 
+std::function<void(const int&, int&, Individual&, QualityTraceWriter&)> EquationSolver::getStrategyFunction()
+{
+	using namespace std::placeholders;
 	switch (m_strategy)
 	{
-		using namespace std::placeholders;
 		default:
-		case EquationSolverStrategy::OnePlusOne: executeEvolutionStrategy(std::bind(&EquationSolver::onePlusOneEvolutionStrategy, this, _1, _2, _3, _4)); break;
-		case EquationSolverStrategy::muPlusLambda: executeEvolutionStrategy(std::bind(&EquationSolver::muPlusLambdaEvolutionStrategy, this, _1, _2, _3, _4)); break;
-		case EquationSolverStrategy::muCommaLambda: executeEvolutionStrategy(std::bind(&EquationSolver::muCommaLambdaEvolutionStrategy, this, _1, _2, _3, _4)); break;
-		case EquationSolverStrategy::muSlashRohPlusLambda: executeEvolutionStrategy(std::bind(&EquationSolver::muSlashRohSharpLambdaEvolutionStrategy, this, _1, _2, _3, _4)); break;
-		case EquationSolverStrategy::muSlashRohCommaLambda: executeEvolutionStrategy(std::bind(&EquationSolver::muSlashRohSharpLambdaEvolutionStrategy, this, _1, _2, _3, _4)); break;
+		case EquationSolverStrategy::OnePlusOne: return std::bind(&EquationSolver::onePlusOneEvolutionStrategy, this, _1, _2, _3, _4);
+		case EquationSolverStrategy::muPlusLambda: return std::bind(&EquationSolver::muPlusLambdaEvolutionStrategy, this, _1, _2, _3, _4);
+		case EquationSolverStrategy::muCommaLambda: return std::bind(&EquationSolver::muCommaLambdaEvolutionStrategy, this, _1, _2, _3, _4);
+		case EquationSolverStrategy::muSlashRohPlusLambda: return std::bind(&EquationSolver::muSlashRohSharpLambdaEvolutionStrategy, this, _1, _2, _3, _4);
+		case EquationSolverStrategy::muSlashRohCommaLambda: return std::bind(&EquationSolver::muSlashRohSharpLambdaEvolutionStrategy, this, _1, _2, _3, _4);
+		case EquationSolverStrategy::CmaEs: return std::bind(&EquationSolver::cmaEvolutionStrategy, this, _1, _2, _3, _4);
 	}
-
-	return 1;
 }
 
 bool EquationSolver::parseCommandLine(int argc, char** argv)
 {
-	const unsigned requiredArgv = 8; //at least for (1+1)
+	const unsigned requiredArgv = 7; //at least for (1+1) with self-adaptive step sizes
 	if (argc < requiredArgv + 1)
 	{
 		showUsage(argv[0]);
@@ -67,6 +80,8 @@ bool EquationSolver::parseCommandLine(int argc, char** argv)
 				m_strategy = EquationSolverStrategy::muSlashRohPlusLambda;
 			else if (strategy == CMD_IDs.MuSlashRohCommaLambda)
 				m_strategy = EquationSolverStrategy::muSlashRohCommaLambda;
+			else if (strategy == CMD_IDs.CmaEs)
+				m_strategy = EquationSolverStrategy::CmaEs;
 		}
 
 		if (arg == CMD_IDs.IndividualRandomRange && i + 2 < argc)
@@ -83,6 +98,9 @@ bool EquationSolver::parseCommandLine(int argc, char** argv)
 			m_mutationRandomRange[1] = std::stoi(max);
 		}
 
+		if (arg == CMD_IDs.SelfAdaptive && i + 1 < argc)
+			m_initialStepSize = std::stod(argv[++i]);
+
 		if (arg == CMD_IDs.Mu && i + 1 < argc)
 			m_mu = std::stoi(argv[++i]);
 
@@ -92,6 +110,65 @@ bool EquationSolver::parseCommandLine(int argc, char** argv)
 		if (arg == CMD_IDs.Roh && i + 1 < argc)
 			m_roh = std::stoi(argv[++i]);
 
+		if (arg == CMD_IDs.Threads && i + 1 < argc)
+			m_threadsAmount = std::stoi(argv[++i]);
+
+		if (arg == CMD_IDs.Trace && i + 1 < argc)
+		{
+			std::string format = argv[++i];
+			if (format == "csv")
+				m_traceFormat = QualityTraceFormat::Csv;
+			else if (format == "binary")
+				m_traceFormat = QualityTraceFormat::Binary;
+			else if (format == "none")
+				m_traceFormat = QualityTraceFormat::None;
+			else
+			{
+				std::cerr << "ERROR: Input Error! Unknown trace format '" << format << "'!\n";
+				return false;
+			}
+		}
+
+		if (arg == CMD_IDs.TraceEvery && i + 1 < argc)
+			m_traceDecimation = std::stoi(argv[++i]);
+
+		if (arg == CMD_IDs.TraceThread)
+			m_traceWriterThread = true;
+
+		if (arg == CMD_IDs.Seed && i + 1 < argc)
+			m_seed = std::stoull(argv[++i]);
+
+		if (arg == CMD_IDs.Runs && i + 1 < argc)
+			m_runsAmount = std::stoi(argv[++i]);
+
+		if (arg == CMD_IDs.Jobs && i + 1 < argc)
+			m_jobsAmount = std::stoi(argv[++i]);
+
+		if (arg == CMD_IDs.ExportRuns)
+			m_exportRuns = true;
+
+		if (arg == CMD_IDs.ExportQueue && i + 1 < argc)
+			m_exportQueueCapacity = std::stoi(argv[++i]);
+
+		if (arg == CMD_IDs.Stats && i + 1 < argc)
+			m_statsInterval = std::stoi(argv[++i]);
+
+		if (arg == CMD_IDs.Result && i + 1 < argc)
+		{
+			std::string format = argv[++i];
+			if (format == "jsonl")
+				m_resultFormat = ResultFormat::JsonLines;
+			else if (format == "binary")
+				m_resultFormat = ResultFormat::Binary;
+			else if (format == "none")
+				m_resultFormat = ResultFormat::None;
+			else
+			{
+				std::cerr << "ERROR: Input Error! Unknown result format '" << format << "'!\n";
+				return false;
+			}
+		}
+
 		if (arg == CMD_IDs.Combination)
 			m_muSlashRohSharpLambdaRecombination = MuSlashRohSharpLambdaRecombination::Combination;
 
@@ -104,6 +181,8 @@ bool EquationSolver::parseCommandLine(int argc, char** argv)
 		std::cerr << "ERROR: Input Error!\n";
 		return false;
 	}
+	if (m_statsInterval > 0 && !Telemetry::IsEnabled())
+		std::cout << "INFO: Built without SOLVER_TELEMETRY, " << CMD_IDs.Stats << " prints nothing\n";
 
 	return true;
 }
@@ -112,9 +191,15 @@ bool EquationSolver::hasCommandLineInputError()
 {
 	if (m_strategy == EquationSolverStrategy::None)
 		return true;
+	if (m_threadsAmount < 0 || m_traceDecimation < 1 || m_runsAmount < 1 || m_jobsAmount < 0 || m_statsInterval < 0 || m_exportQueueCapacity < 1)
+		return true;
 	if ((m_individualRandomRange[0] == 0 && m_individualRandomRange[1] == 0) || m_individualRandomRange[0] > m_individualRandomRange[1])
 		return true;
-	if ((m_mutationRandomRange[0] == 0 && m_mutationRandomRange[1] == 0) || m_mutationRandomRange[0] > m_mutationRandomRange[1])
+	if (m_individualRandomRange[0] < -EquationObjective::MaxGeneMagnitude || m_individualRandomRange[1] > EquationObjective::MaxGeneMagnitude)
+		return true;
+	if (m_initialStepSize < 0)
+		return true;
+	if (m_initialStepSize == 0 && m_strategy != EquationSolverStrategy::CmaEs && ((m_mutationRandomRange[0] == 0 && m_mutationRandomRange[1] == 0) || m_mutationRandomRange[0] > m_mutationRandomRange[1]))
 		return true;
 	if((m_strategy == EquationSolverStrategy::muCommaLambda || m_strategy == EquationSolverStrategy::muPlusLambda || m_strategy == EquationSolverStrategy::muSlashRohPlusLambda || m_strategy == EquationSolverStrategy::muSlashRohCommaLambda)
 		&& (m_mu <= 0 || m_lambda <= 0))
@@ -122,6 +207,8 @@ bool EquationSolver::hasCommandLineInputError()
 	if ((m_strategy == EquationSolverStrategy::muSlashRohPlusLambda || m_strategy == EquationSolverStrategy::muSlashRohCommaLambda)
 		&& (m_roh <= 0 || m_muSlashRohSharpLambdaRecombination == MuSlashRohSharpLambdaRecombination::None))
 		return true;
+	if (m_strategy == EquationSolverStrategy::CmaEs && m_lambda < 0)
+		return true;
 	return false;
 }
 
@@ -132,6 +219,7 @@ void EquationSolver::showUsage(char* appExecutionPath) const
 		<< "Options:\n"
 		<< "\t-h,--help\tShow this help message.\n"
 		<< "\t" << CMD_IDs.Strategy << " <ES>\tchoose a Evolution Strategy listed below!\n"
+		<< "\t" << CMD_IDs.Seed << " <NUM>\tSeed of the random engine, the same seed reproduces a run. Default: random\n"
 
 		<< "\nEvolution Strategies:\n"
 		<< "\t" << CMD_IDs.OnePlusOne << "\tExecutes solver with (1+1) Evolution Strategy with given random parameter.\n"
@@ -139,10 +227,22 @@ void EquationSolver::showUsage(char* appExecutionPath) const
 		<< "\t" << CMD_IDs.MuCommaLambda << "\tExecutes solver with (mu,lambda) Evolution Strategy with given random parameter.\n"
 		<< "\t" << CMD_IDs.MuSlashRohPlusLambda << "\tExecutes solver with (mu/roh+lambda) Evolution Strategy with given random parameter.\n"
 		<< "\t" << CMD_IDs.MuSlashRohCommaLambda << "\tExecutes solver with (mu/roh,lambda) Evolution Strategy with given random parameter.\n"
+		<< "\t" << CMD_IDs.CmaEs << "\tExecutes solver with CMA-ES, the samples are rounded to integer genes.\n"
 
 		<< "\nGeneral Strategy Parameters:\n"
-		<< "\t" << CMD_IDs.IndividualRandomRange << " <MIN> <MAX>\tIndividual self-replication random range.\n"
+		<< "\t" << CMD_IDs.IndividualRandomRange << " <MIN> <MAX>\tIndividual self-replication random range, at most " << EquationObjective::MaxGeneMagnitude << " in magnitude.\n"
 		<< "\t" << CMD_IDs.MutationRandomRange << " <MIN> <MAX>\tMutation random range.\n"
+		<< "\t" << CMD_IDs.SelfAdaptive << " <SIGMA>\tNormal distributed mutations instead of " << CMD_IDs.MutationRandomRange << ", starting with the step size SIGMA. The step size adapts itself per individual, (1+1) uses the 1/5 success rule.\n"
+		<< "\t" << CMD_IDs.Trace << " <csv|binary|none>\tFormat of the quality trace file which is written during the run. Default: csv\n"
+		<< "\t" << CMD_IDs.TraceEvery << " <NUM>\tWrite only every NUM-th iteration into the trace, the last one is always written. Default: 1\n"
+		<< "\t" << CMD_IDs.TraceThread << "\tWrite the trace file on a background thread.\n"
+		<< "\t" << CMD_IDs.Result << " <jsonl|binary|none>\tFormat of '<strategy>_results' with the genes, quality, iterations, evaluations, time, seed and parameters of every run. Default: jsonl\n"
+		<< "\t" << CMD_IDs.Runs << " <NUM>\tIndependent runs with seeds derived from " << CMD_IDs.Seed << ", only a summary is printed and saved in '<strategy>_batch.csv'. Default: 1\n"
+		<< "\t" << CMD_IDs.Jobs << " <NUM>\tRuns which are executed at the same time, 0 uses all hardware threads. Default: 1\n"
+		<< "\t" << CMD_IDs.ExportRuns << "\tSave the trace of every run of " << CMD_IDs.Runs << " as '<strategy>_run<RUN>', one background thread writes the traces of all runs.\n"
+		<< "\t" << CMD_IDs.ExportQueue << " <NUM>\tTrace buffers which may wait for the export, a full queue stops the runs until there's space again. Default: 4\n"
+		<< "\t" << CMD_IDs.Stats << " <NUM>\tPrint the time of every phase and the counters every NUM generations, with --runs only the totals of all runs at the end. Needs a build with SOLVER_TELEMETRY. Default: 0\n"
+		<< "\t" << CMD_IDs.Threads << " <NUM>\tThreads which create, evaluate and select the children, 0 uses all hardware threads. The same seed and amount of threads reproduce a run. Default: 1\n"
 
 		<< "\n" << CMD_IDs.MuPlusLambda << " & " << CMD_IDs.MuCommaLambda << " specific Parameter:\n"
 		<< "\t" << CMD_IDs.Mu << " <NUM>\t\tDefines amount of parents. Needs to be a positive number!\n"
@@ -152,21 +252,45 @@ void EquationSolver::showUsage(char* appExecutionPath) const
 		<< "\t" << CMD_IDs.Mu << ", " << CMD_IDs.Lambda << "\t==> same as above!\n"
 		<< "\t" << CMD_IDs.Roh << " <NUM>\tNumber of parent individuals.\n"
 		<< "\t" << CMD_IDs.Melting << "\tRecombination function 'Melting' -> average of parent genes.\n"
-		<< "\t" << CMD_IDs.Combination << "\tRecombination function 'Combination' -> random gene selection."
+		<< "\t" << CMD_IDs.Combination << "\tRecombination function 'Combination' -> random gene selection.\n"
+
+		<< "\n" << CMD_IDs.CmaEs << " specific Parameter:\n"
+		<< "\t" << CMD_IDs.Lambda << " <NUM>\t\tSamples per generation, the best half is selected. Default: 4 + 3 ln(4)\n"
+		<< "\t" << CMD_IDs.SelfAdaptive << " <SIGMA>\tInitial step size. Default: a quarter of " << CMD_IDs.IndividualRandomRange << "\n"
+		<< "\t" << CMD_IDs.MutationRandomRange << " is not used."
 		<< std::endl;
 }
 
 void EquationSolver::initializeRandomGenerators()
 {
-	m_randomIndividualDistribution = std::uniform_int_distribution<>(m_individualRandomRange[0], m_individualRandomRange[1]);
-	m_randomMutationDistribution = std::uniform_int_distribution<>(m_mutationRandomRange[0], m_mutationRandomRange[1]);
+	m_randomEngine.seed(m_seed);
+	std::cout << "Seed: " << m_seed << std::endl;
+}
+
+void EquationSolver::initializeWorkers()
+{
+	m_threadPool.reset(new ThreadPool(ThreadPool::ResolveThreadsAmount(m_threadsAmount)));
+	int workersAmount = m_threadPool->GetThreadsAmount();
+
+	//stream 0 of the seed belongs to m_randomEngine
+	m_workerEngines.resize(workersAmount);
+	for (int workerIndex = 0; workerIndex < workersAmount; ++workerIndex)
+		Random::SeedStream(m_workerEngines[workerIndex], m_seed, workerIndex + 1);
+}
+
+int EquationSolver::getRandomIndividualGene()
+{
+	return Random::Integer(m_randomEngine, m_individualRandomRange[0], m_individualRandomRange[1]);
+}
+
+void EquationSolver::fillRandomMutations(int* outMutations, const int& amount)
+{
+	Random::FillIntegers(outMutations, amount, m_mutationRandomRange[0], m_mutationRandomRange[1], m_randomEngine);
 }
 
 int EquationSolver::getDiffenceOfEvolutionStrategyEquation(const int& x, const int& y, const int& a, const int& b) const
 {
-	int left = 3 * std::pow(x, 2) + 5 * std::pow(y, 3);
-	int right = 7 * a + 3 * std::pow(b, 2);
-	return std::abs(left - right); // difference
+	return EquationObjective::GetQuality(x, y, a, b); // difference
 }
 
 bool EquationSolver::isEvolutionStrategyCondition1Fulfilled(const Individual& individual) const
@@ -182,6 +306,9 @@ bool EquationSolver::isEvolutionStrategyCondition2Fulfilled(const Individual& in
 void EquationSolver::printSolution(const Individual& solution, const int& iterationCounter, const int& deathCounter) const
 {
 	int x = solution.Genes[0], y = solution.Genes[1], a = solution.Genes[2], b = solution.Genes[3];
+	//both sides in 64 bit integers, the genes are exact and so is the check
+	long long leftSide = 3LL * x * x + 5LL * y * y * y;
+	long long rightSide = 7LL * a + 3LL * b * b;
 
 	std::cout
 		<< "############ SOLUTION ############\n"
@@ -189,276 +316,364 @@ void EquationSolver::printSolution(const Individual& solution, const int& iterat
 		<< "\n############ EQUATION & CONDITION 1 ############\n"
 		<< "3x^2 + 5y^3 = 7a + 3b^2" << std::endl
 		<< "3 * " << x << "^2 + 5 * " << y << "^3 = 7 * " << a << " + 3 " << b << "^2" << std::endl
-		<< 3 * std::pow(x, 2) + 5 * std::pow(y, 3) << " = " << 7 * a + 3 * std::pow(b, 2) << std::endl
+		<< leftSide << " = " << rightSide << std::endl
 		<< "\n############ CONDITION 2 ############\n"
 		<< "a > b ==> " << a << " > " << b << std::endl
 		<< "\n############ SUMMARY ############\n"
 		<< "It took " << iterationCounter << " iterations and " << deathCounter << " death" << ((deathCounter > 0) ? "s" : "") << "!" << std::endl
-		<< "Individual self replication random range: (" << m_individualRandomRange[0] << ", " << m_individualRandomRange[1] << ")" << std::endl
-		<< "Mutation random range: (" << m_mutationRandomRange[0] << ", " << m_mutationRandomRange[1] << ")" << std::endl;
+		<< "Objective evaluations: " << m_evaluationsAmount << std::endl
+		<< "Individual self replication random range: (" << m_individualRandomRange[0] << ", " << m_individualRandomRange[1] << ")" << std::endl;
+	if (m_initialStepSize > 0)
+		std::cout << "Self-adaptive mutation with initial step size: " << m_initialStepSize << std::endl;
+	else
+		std::cout << "Mutation random range: (" << m_mutationRandomRange[0] << ", " << m_mutationRandomRange[1] << ")" << std::endl;
 }
 
-bool EquationSolver::saveToFile(const std::vector<int>& qualityOverIterations, const std::string& path)
+void EquationSolver::executeBatch()
 {
-	std::ofstream outputFile;
-	outputFile.open(path);
-	if (outputFile.is_open())
+	std::cout << "Seed: " << m_seed << ", " << m_runsAmount << " runs" << std::endl;
+	m_telemetry.Reset();
+	BatchRunner batch(ThreadPool::ResolveThreadsAmount(m_jobsAmount));
+	ExportQueue exportQueue(m_exportQueueCapacity);
+	//the records are written by the export thread in the order the runs finish
+	ResultWriter resultWriter;
+	bool resultOpened = resultWriter.Open(getResultFileName(), m_resultFormat, "EquationSolver", getRunParameters());
+	std::vector<BatchRunResult> results;
+	batch.Run(m_runsAmount, [this, &exportQueue, &resultWriter](const int& runIndex, BatchRunResult& outResult)
 	{
-		outputFile << "Iteration" << ";" << "Quality" << "\n";
-		for (int i = 0; i < qualityOverIterations.size(); ++i)
+		//the parsed settings are shared, every run only gets its own engines and workers
+		EquationSolver run(*this);
+		run.m_telemetry.SetObserver(Telemetry::Observer()); //the stats lines of parallel runs would interleave, only the totals are printed
+		run.m_telemetry.Reset();
+		run.m_seed = outResult.Seed = Random::DeriveSeed(m_seed, runIndex);
+		run.m_randomEngine.seed(run.m_seed);
+		run.initializeWorkers();
+
+		Individual solution;
+		int iterationCounter = 0;
+		QualityTraceWriter qualityTrace; //not opened -> nothing is written
+		if (m_exportRuns)
+			qualityTrace.Open(getTraceFileName("_run" + std::to_string(runIndex)), m_traceFormat, m_traceDecimation, exportQueue);
+		auto startTime = std::chrono::steady_clock::now();
+		run.getStrategyFunction()(m_maxIterations, iterationCounter, solution, qualityTrace);
+
+		outResult.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		qualityTrace.Add(0);
+		qualityTrace.Close();
+		outResult.Solved = iterationCounter < m_maxIterations;
+		outResult.Iterations = iterationCounter;
+		outResult.Quality = outResult.Solved ? 0 : run.m_bestQuality;
+		m_telemetry.Add(run.m_telemetry.GetSnapshot());
+
+		if (m_resultFormat != ResultFormat::None)
 		{
-			outputFile << i << ";" << qualityOverIterations[i] << "\n";
+			RunRecord record = run.createRunRecord(solution, outResult);
+			record.Run = runIndex;
+			exportQueue.Push([&resultWriter, record]() { return resultWriter.Write(record); });
 		}
-		outputFile.close();
-		return true;
+	}, results);
+
+	bool exported = exportQueue.Finish();
+	bool resultSaved = resultOpened && resultWriter.Close();
+	BatchRunner::PrintSummary("BestQuality", results);
+	const std::string fileName = to_string(m_strategy) + "_batch.csv";
+	if (BatchRunner::WriteSummary(fileName, "BestQuality", results))
+		std::cout << "Summary saved in '" << fileName << "'" << std::endl;
+	if (m_exportRuns && m_traceFormat != QualityTraceFormat::None)
+	{
+		if (exported)
+			std::cout << "Traces of the runs saved as '" << getTraceFileName("_run<RUN>") << "'" << std::endl;
+		else
+			std::cerr << "ERROR: Couldn't save all traces of the runs!\n";
 	}
+	if (m_resultFormat != ResultFormat::None && resultSaved && exported)
+		std::cout << "Results of the runs saved in '" << getResultFileName() << "'" << std::endl;
+	if (Telemetry::IsEnabled() && m_statsInterval > 0)
+		std::cout << Telemetry::FormatStatsLine(m_telemetry.GetSnapshot()) << "\n";
+}
 
-	std::cout << "ERROR: Could not save file '" << path.c_str() << "'!\n";
-	return false;
+std::string EquationSolver::getResultFileName() const
+{
+	return to_string(m_strategy) + "_results" + ResultFormat::GetFileExtension(m_resultFormat);
 }
 
-void EquationSolver::executeEvolutionStrategy(std::function<void(const int&, int&, Individual&, std::vector<int>&)> strategyFunction)
+std::vector<RunParameter> EquationSolver::getRunParameters() const
+{
+	std::vector<RunParameter> parameters;
+	parameters.push_back(RunParameter::Text("strategy", to_string(m_strategy)));
+	parameters.push_back(RunParameter::Number("seed", m_seed));
+	parameters.push_back(RunParameter::Number("runs", m_runsAmount));
+	parameters.push_back(RunParameter::Number("individualRangeMin", m_individualRandomRange[0]));
+	parameters.push_back(RunParameter::Number("individualRangeMax", m_individualRandomRange[1]));
+	parameters.push_back(RunParameter::Number("mutationRangeMin", m_mutationRandomRange[0]));
+	parameters.push_back(RunParameter::Number("mutationRangeMax", m_mutationRandomRange[1]));
+	parameters.push_back(RunParameter::Number("initialStepSize", m_initialStepSize));
+	parameters.push_back(RunParameter::Number("mu", m_mu));
+	parameters.push_back(RunParameter::Number("lambda", m_lambda));
+	parameters.push_back(RunParameter::Number("roh", m_roh));
+	const char* recombination = m_muSlashRohSharpLambdaRecombination == MuSlashRohSharpLambdaRecombination::Melting ? "melting" : m_muSlashRohSharpLambdaRecombination == MuSlashRohSharpLambdaRecombination::Combination ? "combination" : "none";
+	parameters.push_back(RunParameter::Text("recombination", recombination));
+	parameters.push_back(RunParameter::Number("threads", m_threadsAmount));
+	parameters.push_back(RunParameter::Number("maxIterations", m_maxIterations));
+	return parameters;
+}
+
+RunRecord EquationSolver::createRunRecord(const Individual& solution, const BatchRunResult& result) const
+{
+	RunRecord record;
+	record.Seed = result.Seed;
+	record.Solved = result.Solved;
+	record.Iterations = result.Iterations;
+	record.Evaluations = m_evaluationsAmount;
+	record.Seconds = result.Seconds;
+	record.Fitness = result.Quality;
+	//the strategies only keep the genes of a solution
+	if (result.Solved)
+		record.Genome.assign(solution.Genes, solution.Genes + m_sizeofGenes);
+	return record;
+}
+
+std::string EquationSolver::getTraceFileName(const std::string& suffix) const
+{
+	return to_string(m_strategy) + suffix + (m_traceFormat == QualityTraceFormat::Binary ? ".qtrace" : ".csv");
+}
+
+void EquationSolver::executeEvolutionStrategy(std::function<void(const int&, int&, Individual&, QualityTraceWriter&)> strategyFunction)
 {
 	Individual solution;
 
 	int iterationCounter = 0;
-	int maxIterations = 1000000;
+	const int& maxIterations = m_maxIterations;
 
-	std::vector<int> qualityOverIterations;
-	qualityOverIterations.reserve(maxIterations);
+	m_telemetry.Reset();
+	if (m_statsInterval > 0)
+		m_telemetry.SetObserver(Telemetry::CreateStatsLinePrinter(m_statsInterval));
 
-	strategyFunction(maxIterations, iterationCounter, solution, qualityOverIterations);
+	//the trace gets written while the strategy runs
+	QualityTraceWriter qualityTrace;
+	{
+		TELEMETRY_PHASE(&m_telemetry, TelemetryPhase::IO);
+		qualityTrace.Open(getTraceFileName(""), m_traceFormat, m_traceDecimation, m_traceWriterThread);
+	}
 
-	qualityOverIterations.push_back(0);
-	qualityOverIterations.shrink_to_fit();
+	auto startTime = std::chrono::steady_clock::now();
+	strategyFunction(maxIterations, iterationCounter, solution, qualityTrace);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	{
+		TELEMETRY_PHASE(&m_telemetry, TelemetryPhase::IO);
+		qualityTrace.Add(0);
+		qualityTrace.Close();
+	}
+	if (Telemetry::IsEnabled() && m_statsInterval > 0)
+		std::cout << Telemetry::FormatStatsLine(m_telemetry.GetSnapshot()) << "\n";
 
 	if (iterationCounter < maxIterations)
 		printSolution(solution, iterationCounter, 0);
 	else
-		std::cout << "Exceeded maximum iterations of " << maxIterations << "! -> Couldn't find a solution!\n";
-	saveToFile(qualityOverIterations, to_string(m_strategy) + ".csv");
+		std::cout << "Exceeded maximum iterations of " << maxIterations << " after " << m_evaluationsAmount << " objective evaluations! -> Couldn't find a solution!\n";
+
+	if (m_resultFormat == ResultFormat::None)
+		return;
+	BatchRunResult result;
+	result.Seed = m_seed;
+	result.Solved = iterationCounter < maxIterations;
+	result.Iterations = iterationCounter;
+	result.Seconds = seconds;
+	result.Quality = result.Solved ? 0 : m_bestQuality;
+	ResultWriter resultWriter;
+	if (resultWriter.Open(getResultFileName(), m_resultFormat, "EquationSolver", getRunParameters()) && resultWriter.Write(createRunRecord(solution, result)) && resultWriter.Close())
+		std::cout << "Result saved in '" << getResultFileName() << "'" << std::endl;
+}
+
+double EquationSolver::applyOneFifthSuccessRule(const double& stepSize, const int& successes) const
+{
+	//more than 1/5 successful mutations -> the steps are too careful, less -> they overshoot
+	double successRate = static_cast<double>(successes) / m_successRuleInterval;
+	if (successRate > 0.2)
+		return stepSize / m_successRuleFactor;
+	if (successRate < 0.2)
+		return std::max(stepSize * m_successRuleFactor, m_minStepSize);
+	return stepSize;
 }
 
-void EquationSolver::onePlusOneEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, std::vector<int>& qualityOverIterations)
+void EquationSolver::onePlusOneEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace)
 {
 	Individual individual;
+	int mutations[4];
+	double normals[4];
+	double stepSize = m_initialStepSize;
+	int successes = 0;
 
 	/* -------------------------------------- RANDOM START INDIVIDUAL -------------------------------------- */
-	for (int i = 0; i < m_sizeofGenes; ++i)
-		individual.Genes[i] = m_randomIndividualDistribution(m_mersenneTwisterEngine);
+	{
+		TELEMETRY_PHASE(&m_telemetry, TelemetryPhase::Initialization);
+		for (int i = 0; i < m_sizeofGenes; ++i)
+			individual.Genes[i] = getRandomIndividualGene();
+	}
+	m_evaluationsAmount = 1;
+	TELEMETRY_COUNT(&m_telemetry, TelemetryCounter::FitnessEvaluations, 1);
 
 	/* -------------------------------------- START EVOLUTION -------------------------------------- */
 	for (; iterationCounter <= maxIterations; ++iterationCounter)
 	{
+		//the selection continues early, so every iteration ends the previous one
+		if (iterationCounter > 0)
+			TELEMETRY_END_GENERATION(&m_telemetry);
+
 		/* -------------------------------------- SELF-REPLICATION -------------------------------------- */
 		Individual mutation = individual;
+		TELEMETRY_COUNT(&m_telemetry, TelemetryCounter::Copies, 1);
 
 		/* -------------------------------------- RANDOM MUTATION -------------------------------------- */
-		for (int i = 0; i < m_sizeofGenes; ++i)
-			mutation.Genes[i] += m_randomMutationDistribution(m_mersenneTwisterEngine);
-
-		/* -------------------------------------- SELECTION -------------------------------------- */
-		individual.Usable = isEvolutionStrategyCondition2Fulfilled(individual);
-		mutation.Usable = isEvolutionStrategyCondition2Fulfilled(mutation);
-
-		//is one of the individuals a solution?
-		if (foundSolution(&individual, 1, solution) || foundSolution(&mutation, 1, solution))
-			break;
-
-		//is just individual usable?
-		if (individual.Usable && !mutation.Usable)
-			continue;
-
-		//is just mutation usable -> use mutation as new individual
-		if (mutation.Usable && !individual.Usable)
 		{
-			individual = mutation;
-			continue;
+			TELEMETRY_PHASE(&m_telemetry, TelemetryPhase::Mutation);
+			if (m_initialStepSize > 0)
+			{
+				if (iterationCounter > 0 && iterationCounter % m_successRuleInterval == 0)
+				{
+					stepSize = applyOneFifthSuccessRule(stepSize, successes);
+					successes = 0;
+				}
+				Random::FillNormals(normals, 4, m_randomEngine);
+				for (int i = 0; i < m_sizeofGenes; ++i)
+					mutation.Genes[i] += static_cast<int>(std::lround(stepSize * normals[i]));
+			}
+			else
+			{
+				fillRandomMutations(mutations, 4);
+				for (int i = 0; i < m_sizeofGenes; ++i)
+					mutation.Genes[i] += mutations[i];
+			}
 		}
 
-		//determine better
-		individual.Quality = individual.Usable ? getDiffenceOfEvolutionStrategyEquation(individual.Genes[0], individual.Genes[1], individual.Genes[2], individual.Genes[3]) : std::numeric_limits<int>::max();
-		mutation.Quality = mutation.Usable ? getDiffenceOfEvolutionStrategyEquation(mutation.Genes[0], mutation.Genes[1], mutation.Genes[2], mutation.Genes[3]) : std::numeric_limits<int>::max();
-
-		//if mutation is better
-		if (mutation.Quality < individual.Quality)
-			individual = mutation;
+		/* -------------------------------------- SELECTION -------------------------------------- */
+		//the parent is known already, only the mutation is a new evaluation
+		++m_evaluationsAmount;
+		TELEMETRY_COUNT(&m_telemetry, TelemetryCounter::FitnessEvaluations, 1);
+		{
+			TELEMETRY_PHASE(&m_telemetry, TelemetryPhase::Selection);
+			individual.Usable = isEvolutionStrategyCondition2Fulfilled(individual);
+			mutation.Usable = isEvolutionStrategyCondition2Fulfilled(mutation);
 
-		//save new best quality level
-		qualityOverIterations.push_back(individual.Quality);
-	}
-}
+			//is one of the individuals a solution?
+			if (foundSolution(&individual, 1, solution) || foundSolution(&mutation, 1, solution))
+				break;
 
-void EquationSolver::muPlusLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, std::vector<int>& qualityOverIterations)
-{
-	std::vector<Individual> parents, children, individuals;
-	parents.resize(m_mu);
-	children.resize(m_lambda); 
-	individuals.resize(m_mu + m_lambda);
+			//is just individual usable?
+			if (individual.Usable && !mutation.Usable)
+				continue;
 
-	std::uniform_int_distribution<> randomParentDistribution(0, m_mu - 1);
+			//is just mutation usable -> use mutation as new individual
+			if (mutation.Usable && !individual.Usable)
+			{
+				individual = mutation;
+				++successes;
+				continue;
+			}
 
-	/* -------------------------------------- RANDOM START PARENTS -------------------------------------- */
-	for (int i = 0; i < parents.size(); ++i)
-		for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
-			parents[i].Genes[geneIndex] = m_randomIndividualDistribution(m_mersenneTwisterEngine);
+			//determine better
+			individual.Quality = individual.Usable ? getDiffenceOfEvolutionStrategyEquation(individual.Genes[0], individual.Genes[1], individual.Genes[2], individual.Genes[3]) : std::numeric_limits<int>::max();
+			mutation.Quality = mutation.Usable ? getDiffenceOfEvolutionStrategyEquation(mutation.Genes[0], mutation.Genes[1], mutation.Genes[2], mutation.Genes[3]) : std::numeric_limits<int>::max();
 
-	/* -------------------------------------- START EVOLUTION -------------------------------------- */
-	for(; iterationCounter <= maxIterations; ++iterationCounter)
-	{
-		//add all new parents to a summary array
-		for(int i = 0; i < parents.size(); ++i)
-			individuals[i] = parents[i];
+			//if mutation is better
+			if (mutation.Quality < individual.Quality)
+			{
+				individual = mutation;
+				++successes;
+			}
+		}
 
-		for(int i = 0; i < children.size(); ++i)
+		//save new best quality level
 		{
-			/* -------------------------------------- SELF-REPLICATION -------------------------------------- */
-			children[i] = parents[randomParentDistribution(m_mersenneTwisterEngine)];
-
-			/* -------------------------------------- RANDOM MUTATION -------------------------------------- */
-			for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
-				children[i].Genes[geneIndex] += m_randomMutationDistribution(m_mersenneTwisterEngine);
-
-			//add to a summary array
-			individuals[parents.size()+ i] = children[i];
+			TELEMETRY_PHASE(&m_telemetry, TelemetryPhase::IO);
+			qualityTrace.Add(individual.Quality);
 		}
-
-		/* -------------------------------------- SELECTION -------------------------------------- */
-		if (checkConditionsAndReturnTrueIfSolutionFound(individuals, solution))
-			break;
-
-		plusSelection(individuals, parents, qualityOverIterations);
 	}
+	TELEMETRY_END_GENERATION(&m_telemetry);
+
+	m_bestQuality = individual.Usable ? getDiffenceOfEvolutionStrategyEquation(individual.Genes[0], individual.Genes[1], individual.Genes[2], individual.Genes[3]) : INT_MAX;
 }
 
-void EquationSolver::muCommaLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, std::vector<int>& qualityOverIterations)
+void EquationSolver::muPlusLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace)
 {
-	std::vector<Individual> parents, children, individuals;
-	parents.resize(m_mu);
-	children.resize(m_lambda);
-	individuals.resize(m_mu + m_lambda);
-
-	std::uniform_int_distribution<> randomParentDistribution(0, m_mu - 1);
-
-	/* -------------------------------------- RANDOM START PARENTS -------------------------------------- */
-	for (int i = 0; i < parents.size(); ++i)
-		for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
-			parents[i].Genes[geneIndex] = m_randomIndividualDistribution(m_mersenneTwisterEngine);
-
-	/* -------------------------------------- START EVOLUTION -------------------------------------- */
-	for (; iterationCounter <= maxIterations; ++iterationCounter)
-	{
-		//add all new parents to a summary array
-		for (int i = 0; i < parents.size(); ++i)
-			individuals[i] = parents[i];
-
-		for (int i = 0; i < children.size(); ++i)
-		{
-			/* -------------------------------------- SELF-REPLICATION -------------------------------------- */
-			children[i] = parents[randomParentDistribution(m_mersenneTwisterEngine)];
-
-			/* -------------------------------------- RANDOM MUTATION -------------------------------------- */
-			for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
-				children[i].Genes[geneIndex] += m_randomMutationDistribution(m_mersenneTwisterEngine);
-
-			//add to a summary array
-			individuals[parents.size() + i] = children[i];
-		}
-
-		/* -------------------------------------- SELECTION -------------------------------------- */
-		if (checkConditionsAndReturnTrueIfSolutionFound(individuals, solution))
-			break;
-
-		commaSelection(parents, children, individuals, qualityOverIterations);
-	}
+	evolvePopulation(maxIterations, iterationCounter, solution, qualityTrace);
 }
 
-void EquationSolver::muSlashRohSharpLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, std::vector<int>& qualityOverIterations)
+void EquationSolver::muCommaLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace)
 {
-	std::vector<Individual> parents, children, individuals;
-	parents.resize(m_mu);
-	children.resize(m_lambda);
-	individuals.resize(m_mu + m_lambda);
-
-	std::uniform_int_distribution<> randomParentDistribution(0, m_mu - 1);
-	std::uniform_int_distribution<> randomGeneDistribution(0, m_roh - 1);
-
-	/* -------------------------------------- RANDOM START PARENTS -------------------------------------- */
-	for (int i = 0; i < parents.size(); ++i)
-		for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
-			parents[i].Genes[geneIndex] = m_randomIndividualDistribution(m_mersenneTwisterEngine);
-
-	/* -------------------------------------- START EVOLUTION -------------------------------------- */
-	for (; iterationCounter <= maxIterations; ++iterationCounter)
-	{
-		//add all new parents to a summary array
-		for (int i = 0; i < parents.size(); ++i)
-			individuals[i] = parents[i];
-
-		for (int i = 0; i < children.size(); ++i)
-		{
-			/* -------------------------------------- RECOMBINATION -------------------------------------- */
-			muSlashRohSharpLambaRecombination(parents, children[i], randomParentDistribution, randomGeneDistribution);
-
-			/* -------------------------------------- RANDOM MUTATION -------------------------------------- */
-			for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
-				children[i].Genes[geneIndex] += m_randomMutationDistribution(m_mersenneTwisterEngine);
-
-			//add to a summary array
-			individuals[parents.size() + i] = children[i];
-		}
-
-		/* -------------------------------------- SELECTION -------------------------------------- */
-		if (checkConditionsAndReturnTrueIfSolutionFound(individuals, solution))
-			break;
+	evolvePopulation(maxIterations, iterationCounter, solution, qualityTrace);
+}
 
-		if (m_strategy == EquationSolverStrategy::muSlashRohPlusLambda)
-			plusSelection(individuals, parents, qualityOverIterations);
-		else if(m_strategy == EquationSolverStrategy::muSlashRohCommaLambda)
-			commaSelection(parents, children, individuals, qualityOverIterations);
-	}
+void EquationSolver::muSlashRohSharpLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace)
+{
+	evolvePopulation(maxIterations, iterationCounter, solution, qualityTrace);
 }
 
-void EquationSolver::muSlashRohSharpLambaRecombination(std::vector<Individual>& parents, Individual& outChild,  const std::uniform_int_distribution<>& randomParentDistribution, const std::uniform_int_distribution<>& randomGeneDistribution)
+void EquationSolver::evolvePopulation(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace)
 {
-	if (m_muSlashRohSharpLambdaRecombination == MuSlashRohSharpLambdaRecombination::Combination)
+	EquationStrategy::Settings settings;
+	settings.Mu = m_mu;
+	settings.Lambda = m_lambda;
+	settings.Roh = m_roh;
+	bool recombination = m_strategy == EquationSolverStrategy::muSlashRohPlusLambda || m_strategy == EquationSolverStrategy::muSlashRohCommaLambda;
+	settings.Recombination = recombination ? m_muSlashRohSharpLambdaRecombination : MuSlashRohSharpLambdaRecombination::None;
+	settings.PlusSelection = m_strategy == EquationSolverStrategy::muPlusLambda || m_strategy == EquationSolverStrategy::muSlashRohPlusLambda;
+	for (int i = 0; i < 2; ++i)
 	{
-		std::vector<Individual*> randomParents;
-		randomParents.reserve(m_roh);
-		for (int p = 0; p < m_roh; ++p)
-		{
-			randomParents.push_back(&parents[randomParentDistribution(m_mersenneTwisterEngine)]);
-		}
-		for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
-		{
-			outChild.Genes[geneIndex] = randomParents[randomGeneDistribution(m_mersenneTwisterEngine)]->Genes[geneIndex];
-		}
+		settings.IndividualRandomRange[i] = m_individualRandomRange[i];
+		settings.MutationRandomRange[i] = m_mutationRandomRange[i];
 	}
-	else if (m_muSlashRohSharpLambdaRecombination == MuSlashRohSharpLambdaRecombination::Melting)
+	settings.InitialStepSize = m_initialStepSize;
+	settings.MinStepSize = m_minStepSize;
+	settings.MaxIterations = maxIterations;
+	settings.Recorder = &m_telemetry;
+
+	EquationStrategy strategy(settings, *m_threadPool, m_workerEngines);
+	EquationGenome genome;
+	bool solved = strategy.Evolve(m_randomEngine, iterationCounter, genome, [this, &qualityTrace](const int& bestQuality)
 	{
-		outChild.Reset();
-		for (int p = 0; p < m_roh; ++p)
-		{
-			for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
-			{
-				outChild.Genes[geneIndex] += parents[randomParentDistribution(m_mersenneTwisterEngine)].Genes[geneIndex];
-			}
-		}
-		for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
-			outChild.Genes[geneIndex] /= m_roh;
-	}
+		m_bestQuality = bestQuality;
+		TELEMETRY_PHASE(&m_telemetry, TelemetryPhase::IO);
+		qualityTrace.Add(bestQuality);
+	});
+	m_evaluationsAmount = strategy.GetEvaluationsAmount();
+	if (!solved)
+		return;
+
+	for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
+		solution.Genes[geneIndex] = genome.Genes[geneIndex];
+	solution.Usable = true;
+	solution.Quality = 0;
 }
 
-bool EquationSolver::checkConditionsAndReturnTrueIfSolutionFound(std::vector<Individual>& individuals, Individual& solution) const
-{	
-	//which of the individuals fulfill the condition 2?
-	for (int i = 0; i < individuals.size(); ++i)
-		individuals[i].Usable = isEvolutionStrategyCondition2Fulfilled(individuals[i]);
-
-	//is one of the individuals the solution?
-	if (foundSolution(&individuals[0], individuals.size(), solution))
-		return true;
-	return false;
+void EquationSolver::cmaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace)
+{
+	EquationCmaStrategy::Settings settings;
+	settings.Lambda = m_lambda;
+	for (int i = 0; i < 2; ++i)
+		settings.IndividualRandomRange[i] = m_individualRandomRange[i];
+	settings.InitialStepSize = m_initialStepSize > 0 ? m_initialStepSize : (m_individualRandomRange[1] - m_individualRandomRange[0]) / 4.0;
+	settings.MinStepSize = m_minStepSize;
+	settings.MaxIterations = maxIterations;
+	settings.Recorder = &m_telemetry;
+
+	EquationCmaStrategy strategy(settings, *m_threadPool, m_workerEngines);
+	EquationGenome genome;
+	bool solved = strategy.Evolve(m_randomEngine, iterationCounter, genome, [this, &qualityTrace](const int& bestQuality)
+	{
+		m_bestQuality = bestQuality;
+		TELEMETRY_PHASE(&m_telemetry, TelemetryPhase::IO);
+		qualityTrace.Add(bestQuality);
+	});
+	m_evaluationsAmount = strategy.GetEvaluationsAmount();
+	if (!solved)
+		return;
+
+	for (int geneIndex = 0; geneIndex < m_sizeofGenes; ++geneIndex)
+		solution.Genes[geneIndex] = genome.Genes[geneIndex];
+	solution.Usable = true;
+	solution.Quality = 0;
 }
 
 bool EquationSolver::foundSolution(const Individual* individualsArray, const size_t& amount, Individual& outSolution) const
@@ -473,37 +688,3 @@ bool EquationSolver::foundSolution(const Individual* individualsArray, const siz
 	}
 	return false;
 }
-
-void EquationSolver::plusSelection(std::vector<Individual>& inOutIndividuals, std::vector<Individual>& inOutParents, std::vector<int>& inOutQualityOverIterations)
-{			
-	//determine quality
-	for (int i = 0; i < inOutIndividuals.size(); ++i)
-		inOutIndividuals[i].Quality = inOutIndividuals[i].Usable ? getDiffenceOfEvolutionStrategyEquation(inOutIndividuals[i].Genes[0], inOutIndividuals[i].Genes[1], inOutIndividuals[i].Genes[2], inOutIndividuals[i].Genes[3]) : std::numeric_limits<int>::max();
-
-	std::random_shuffle(inOutIndividuals.begin(), inOutIndividuals.end());
-	std::sort(inOutIndividuals.begin(), inOutIndividuals.end(), [](const Individual& lhs, const Individual& rhs) { return lhs.Quality < rhs.Quality; });
-
-	//save best quality level
-	inOutQualityOverIterations.push_back(inOutIndividuals[0].Quality);
-
-	//choose mu best individuals from all individuals
-	for (int i = 0; i < inOutParents.size(); ++i)
-		inOutParents[i] = inOutIndividuals[i];
-}
-
-void EquationSolver::commaSelection(std::vector<Individual>& inOutParents, std::vector<Individual>& inOutChildren, const std::vector<Individual>& individuals, std::vector<int>& inOutQualityOverIterations)
-{			
-	//determine quality
-	for (int i = 0; i < inOutChildren.size(); ++i)
-		inOutChildren[i].Quality = individuals[inOutParents.size() + i].Usable ? getDiffenceOfEvolutionStrategyEquation(inOutChildren[i].Genes[0], inOutChildren[i].Genes[1], inOutChildren[i].Genes[2], inOutChildren[i].Genes[3]) : std::numeric_limits<int>::max();
-
-	std::random_shuffle(inOutChildren.begin(), inOutChildren.end());
-	std::sort(inOutChildren.begin(), inOutChildren.end(), [](const Individual& lhs, const Individual& rhs) { return lhs.Quality < rhs.Quality; });
-
-	//save best quality level
-	inOutQualityOverIterations.push_back(inOutChildren[0].Quality);
-
-	//choose mu best individuals from all individuals
-	for (int i = 0; i < inOutParents.size(); ++i)
-		inOutParents[i] = inOutChildren[i % inOutChildren.size()];
-}
@@ -3,6 +3,14 @@
 #include <vector>
 #include <random>
 #include <functional>
+#include <memory>
+#include <climits>
+#include "../Common/RandomEngine.h"
+#include "EquationProblem.h"
+#include "QualityTraceWriter.h"
+#include "../Common/Telemetry.h"
+#include "../Common/ResultWriter.h"
+#include "../Common/BatchRunner.h"
 
 struct Individual
 {
@@ -36,7 +44,8 @@ namespace EquationSolverStrategy
 		muPlusLambda,
 		muCommaLambda,
 		muSlashRohPlusLambda,
-		muSlashRohCommaLambda
+		muSlashRohCommaLambda,
+		CmaEs
 	};
 
 	inline std::string to_string(Enum strategy)
@@ -50,18 +59,10 @@ namespace EquationSolverStrategy
 		case muCommaLambda: return "muCommaLambda";
 		case muSlashRohPlusLambda: return "muSlashRohPlusLambda";
 		case muSlashRohCommaLambda: return "muSlashRohCommaLambda";
+		case CmaEs: return "CmaEs";
 		}
 	}
 }
-namespace MuSlashRohSharpLambdaRecombination
-{
-	enum Enum
-	{
-		None,
-		Melting,
-		Combination
-	};
-}
 class EquationSolver
 {
 public:
@@ -71,29 +72,41 @@ public:
 	int Execute(int argc, char** argv);
 
 private:
+	friend class EquationSolverBenchmark; //runs the strategies with fixed seeds and measures the equation on its own
+
 	bool parseCommandLine(int argc, char** argv);
 	bool hasCommandLineInputError();
 	void showUsage(char* appExecutionPath) const;
 
 	void initializeRandomGenerators();
+	void initializeWorkers();
+	int getRandomIndividualGene();
+	void fillRandomMutations(int* outMutations, const int& amount);
 
 	int getDiffenceOfEvolutionStrategyEquation(const int& x, const int& y, const int& a, const int& b) const;
 	bool isEvolutionStrategyCondition1Fulfilled(const Individual& individual) const;
 	static bool isEvolutionStrategyCondition2Fulfilled(const Individual& individual);
 		
 	void printSolution(const Individual& solution, const int& iterationCounter, const int& deathCounter) const;
-	static bool saveToFile(const std::vector<int>& qualityOverIterations, const std::string& path);
 
-	void executeEvolutionStrategy(std::function<void(const int&, int&, Individual&, std::vector<int>&)> strategyFunction);
-	void onePlusOneEvolutionStrategy(const int& maxIterations, int& outIterationCounter, Individual& outSolution, std::vector<int>& qualityOverIterations);
-	void muPlusLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, std::vector<int>& qualityOverIterations);
-	void muCommaLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, std::vector<int>& qualityOverIterations);
-	void muSlashRohSharpLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, std::vector<int>& qualityOverIterations);
-	void muSlashRohSharpLambaRecombination( std::vector<Individual>& parents, Individual& outChild, const std::uniform_int_distribution<>& randomParentDistribution, const std::uniform_int_distribution<>& randomGeneDistribution);
-	bool checkConditionsAndReturnTrueIfSolutionFound(std::vector<Individual>& inOutIndividuals, Individual& outSolution) const;
+	std::function<void(const int&, int&, Individual&, QualityTraceWriter&)> getStrategyFunction();
+	//independent runs with derived seeds, only the summary is printed and saved, the traces of the runs are optionally exported in the background
+	void executeBatch();
+	std::string getTraceFileName(const std::string& suffix) const;
+	std::string getResultFileName() const;
+	std::vector<RunParameter> getRunParameters() const;
+	RunRecord createRunRecord(const Individual& solution, const BatchRunResult& result) const;
+	void executeEvolutionStrategy(std::function<void(const int&, int&, Individual&, QualityTraceWriter&)> strategyFunction);
+	double applyOneFifthSuccessRule(const double& stepSize, const int& successes) const;
+	void onePlusOneEvolutionStrategy(const int& maxIterations, int& outIterationCounter, Individual& outSolution, QualityTraceWriter& qualityTrace);
+	void muPlusLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace);
+	void muCommaLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace);
+	void muSlashRohSharpLambdaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace);
+	//all strategies with a population of mu parents and lambda children
+	void evolvePopulation(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace);
+	//covariance matrix adaptation on the rounded genes
+	void cmaEvolutionStrategy(const int& maxIterations, int& iterationCounter, Individual& solution, QualityTraceWriter& qualityTrace);
 	bool foundSolution(const Individual* individualsArray, const size_t& amount, Individual& outSolution) const;
-	void plusSelection(std::vector<Individual>& inOutIndividuals, std::vector<Individual>& inOutParents, std::vector<int>& inOutQualityOverIterations);
-	void commaSelection(std::vector<Individual>& inOutParents, std::vector<Individual>& inOutChildren, const std::vector<Individual>& individuals, std::vector<int>& inOutQualityOverIterations);
 
 	const size_t m_sizeofGenes = 4;
 	EquationSolverStrategy::Enum m_strategy = EquationSolverStrategy::None;
@@ -103,11 +116,31 @@ private:
 	int m_lambda = 0;
 	int m_roh = 0;
 	MuSlashRohSharpLambdaRecombination::Enum m_muSlashRohSharpLambdaRecombination = MuSlashRohSharpLambdaRecombination::None;
+	//> 0 replaces the mutation range by normal distributed mutations with self-adaptive step sizes
+	double m_initialStepSize = 0;
+	long long m_evaluationsAmount = 0; //of the last run, to compare the strategies
+	const double m_minStepSize = 1.0; //below one most normal distributed steps round to zero and the integer genes stop moving
+	//1/5 success rule of (1+1) -> the step size is adapted every 10 * genes mutations with the factor of Schwefel
+	const int m_successRuleInterval = 40;
+	const double m_successRuleFactor = 0.817;
 
-	std::random_device m_randomDevice; 
-	std::mt19937_64 m_mersenneTwisterEngine;
-	std::uniform_int_distribution<> m_randomIndividualDistribution;
-	std::uniform_int_distribution<> m_randomMutationDistribution;
+	unsigned long long m_seed;
+	int m_threadsAmount = 1;
+	QualityTraceFormat::Enum m_traceFormat = QualityTraceFormat::Csv;
+	int m_traceDecimation = 1;
+	bool m_traceWriterThread = false;
+	ResultFormat::Enum m_resultFormat = ResultFormat::JsonLines;
+	RandomEngine m_randomEngine;
+	std::shared_ptr<ThreadPool> m_threadPool; //the runs of a batch start as copies of the parsed solver and replace it by their own
+	int m_runsAmount = 1;
+	int m_jobsAmount = 1;
+	bool m_exportRuns = false;
+	int m_exportQueueCapacity = 4;
+	const int m_maxIterations = 1000000;
+	int m_bestQuality = INT_MAX; //of the last generation
+	int m_statsInterval = 0; //0 -> no stats lines
+	Telemetry m_telemetry;
+	std::vector<RandomEngine> m_workerEngines;
 
 	const struct CmdIdentifier
 	{
@@ -117,13 +150,26 @@ private:
 		const char* MuCommaLambda = "(m,l)";
 		const char* MuSlashRohPlusLambda = "(m/r+l)";
 		const char* MuSlashRohCommaLambda = "(m/r,l)";
+		const char* CmaEs = "(cma)";
 		const char* IndividualRandomRange = "--i-range";
 		const char* MutationRandomRange = "--m-range";
+		const char* SelfAdaptive = "--self-adaptive";
 		const char* Mu = "--mu";
 		const char* Lambda = "--lambda";
 		const char* Roh = "--roh";
 		const char* Melting = "--melting";
 		const char* Combination = "--combination";
+		const char* Seed = "--seed";
+		const char* Threads = "--threads";
+		const char* Trace = "--trace";
+		const char* TraceEvery = "--trace-every";
+		const char* TraceThread = "--trace-thread";
+		const char* Runs = "--runs";
+		const char* Jobs = "--jobs";
+		const char* ExportRuns = "--export-runs";
+		const char* ExportQueue = "--export-queue";
+		const char* Stats = "--stats";
+		const char* Result = "--result";
 	} CMD_IDs;
 };
 
@@ -0,0 +1,357 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include "../Common/RandomEngine.h"
+#include "../Common/ThreadPool.h"
+#include "../Common/Telemetry.h"
+#include "TopSelection.h"
+
+namespace MuSlashRohSharpLambdaRecombination
+{
+	enum Enum
+	{
+		None,
+		Melting,
+		Combination
+	};
+}
+
+//gene type and gene count are known at compile time, so every loop over the genes gets unrolled
+template<typename Gene, int GenesAmount>
+struct Genome
+{
+	typedef Gene GeneType;
+	static const int Size = GenesAmount;
+
+	Gene Genes[GenesAmount];
+};
+
+//the interface an objective and a constraint have to offer:
+//objective -> typedef Quality; Quality operator()(const Gene (&genes)[Size]) const, lower is better; bool IsSolution(const Quality& quality) const
+//constraint -> bool operator()(const Gene (&genes)[Size]) const, individuals which violate it get the worst quality and are never a solution
+
+//evaluates one individual after the other, with the objective inlined the compiler can vectorize over the individuals
+template<typename GenomeType, typename Objective, typename Constraint>
+struct ScalarEvaluator
+{
+	typedef typename GenomeType::GeneType Gene;
+	typedef typename Objective::Quality Quality;
+
+	//quality of [begin, end), returns the first solution or -1
+	static int Evaluate(const Gene* const* genes, Quality* outQualities, const int& begin, const int& end, const Objective& objective, const Constraint& constraint)
+	{
+		int solution = -1;
+		for (int i = begin; i < end; ++i)
+		{
+			Gene individual[GenomeType::Size];
+			for (int geneIndex = 0; geneIndex < GenomeType::Size; ++geneIndex)
+				individual[geneIndex] = genes[geneIndex][i];
+
+			bool usable = constraint(individual);
+			Quality quality = usable ? objective(individual) : std::numeric_limits<Quality>::max();
+			outQualities[i] = quality;
+			if (usable && solution < 0 && objective.IsSolution(quality))
+				solution = i;
+		}
+		return solution;
+	}
+};
+
+//splits [begin, end) between the workers of a pool, the ranges are aligned to whole AVX-512 registers
+template<typename GenomeType, typename Objective, typename Constraint, typename Evaluator>
+struct ParallelEvaluator
+{
+	typedef typename GenomeType::GeneType Gene;
+	typedef typename Objective::Quality Quality;
+
+	//quality of [begin, end), returns the first solution or -1, workerSolutionIndices needs one entry per thread
+	static int Evaluate(const Gene* const* genes, Quality* outQualities, const int& begin, const int& end, const Objective& objective, const Constraint& constraint, ThreadPool& threadPool, std::vector<int>& workerSolutionIndices)
+	{
+		threadPool.Run([&](int workerIndex)
+		{
+			int workerBegin, workerEnd;
+			ThreadPool::GetWorkerRange(workerIndex, threadPool.GetThreadsAmount(), end - begin, 16, workerBegin, workerEnd);
+			workerSolutionIndices[workerIndex] = workerBegin < workerEnd ? Evaluator::Evaluate(genes, outQualities, begin + workerBegin, begin + workerEnd, objective, constraint) : -1;
+		});
+
+		//the lowest index wins like in a serial evaluation, so the result doesn't depend on the amount of threads
+		int solution = -1;
+		for (int workerIndex = 0; workerIndex < workerSolutionIndices.size() && solution < 0; ++workerIndex)
+			solution = workerSolutionIndices[workerIndex];
+		return solution;
+	}
+};
+
+//(mu + lambda), (mu, lambda) and (mu/roh #lambda) for any problem without virtual calls, the evaluator can be replaced by a hand vectorized one
+template<typename GenomeType, typename Objective, typename Constraint, typename Evaluator = ScalarEvaluator<GenomeType, Objective, Constraint>>
+class EvolutionStrategy
+{
+public:
+	typedef typename GenomeType::GeneType Gene;
+	typedef typename Objective::Quality Quality;
+	static const int GenesAmount = GenomeType::Size;
+
+	struct Settings
+	{
+		int Mu = 1;
+		int Lambda = 1;
+		int Roh = 0; //parents per child, only used with a recombination
+		MuSlashRohSharpLambdaRecombination::Enum Recombination = MuSlashRohSharpLambdaRecombination::None;
+		bool PlusSelection = true; //parents compete with the children, otherwise only the children survive
+		Gene IndividualRandomRange[2] = {}; //genes of the random start parents
+		Gene MutationRandomRange[2] = {};
+		//> 0 replaces the mutation range by a normal distributed mutation with one self-adaptive step size per individual
+		double InitialStepSize = 0;
+		double MinStepSize = 0; //integer genes need a step size which still rounds to a change now and then
+		int MaxIterations = 1000000;
+		Telemetry* Recorder = nullptr; //phases and counters of the run, nullptr records nothing
+	};
+
+	//the worker engines have to be seeded independently, one per thread of the pool
+	EvolutionStrategy(const Settings& settings, ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines, const Objective& objective = Objective(), const Constraint& constraint = Constraint())
+		: m_settings(settings), m_threadPool(threadPool), m_workerEngines(workerEngines), m_objective(objective), m_constraint(constraint)
+	{
+		int allocations = 0;
+		for (auto& population : m_populations)
+			allocations += population.Resize(m_settings.Mu + m_settings.Lambda);
+
+		int workersAmount = m_threadPool.GetThreadsAmount();
+		allocations += Telemetry::ResizeBuffer(m_workerSolutionIndices, workersAmount);
+		allocations += Telemetry::ResizeBuffer(m_parentIndices, m_settings.Lambda);
+		allocations += Telemetry::ResizeBuffer(m_mutations, m_settings.Lambda * GenesAmount);
+		if (isSelfAdaptive())
+			allocations += Telemetry::ResizeBuffer(m_normals, m_settings.Lambda * (GenesAmount + 1));
+		allocations += Telemetry::ResizeBuffer(m_recombinationParents, workersAmount * std::max(m_settings.Roh, 1));
+		TELEMETRY_COUNT(m_settings.Recorder, TelemetryCounter::Allocations, allocations);
+	}
+
+	//onGeneration(bestQuality) is called after every selection, returns true if a solution was found before the iterations ran out
+	template<typename GenerationCallback>
+	bool Evolve(RandomEngine& randomEngine, int& iterationCounter, GenomeType& outSolution, GenerationCallback onGeneration)
+	{
+		m_currentPopulation = 0;
+		m_evaluationsAmount = 0;
+
+		/* -------------------------------------- RANDOM START PARENTS -------------------------------------- */
+		{
+			TELEMETRY_PHASE(m_settings.Recorder, TelemetryPhase::Initialization);
+			Population& startPopulation = m_populations[m_currentPopulation];
+			for (int i = 0; i < m_settings.Mu; ++i)
+				for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+					startPopulation.Genes[geneIndex][i] = drawGene(randomEngine, m_settings.IndividualRandomRange[0], m_settings.IndividualRandomRange[1]);
+			std::fill(startPopulation.StepSizes.begin(), startPopulation.StepSizes.begin() + m_settings.Mu, m_settings.InitialStepSize);
+		}
+
+		if (evaluateAndReturnTrueIfSolutionFound(0, m_settings.Mu, outSolution))
+			return true;
+
+		/* -------------------------------------- START EVOLUTION -------------------------------------- */
+		for (; iterationCounter <= m_settings.MaxIterations; ++iterationCounter)
+		{
+			/* -------------------------------------- SELF-REPLICATION OR RECOMBINATION & RANDOM MUTATION -------------------------------------- */
+			createChildren();
+
+			/* -------------------------------------- SELECTION -------------------------------------- */
+			//the parents are already checked, only a child can be the solution
+			if (evaluateAndReturnTrueIfSolutionFound(m_settings.Mu, m_settings.Mu + m_settings.Lambda, outSolution))
+				return true;
+
+			onGeneration(select(randomEngine));
+			TELEMETRY_END_GENERATION(m_settings.Recorder);
+		}
+		return false;
+	}
+
+	long long GetEvaluationsAmount() const { return m_evaluationsAmount; }
+
+private:
+	//genes of all individuals in structure of arrays form
+	struct Population
+	{
+		std::vector<Gene> Genes[GenesAmount];
+		std::vector<Quality> Qualities;
+		std::vector<double> StepSizes; //only used with self-adaptation
+
+		//returns the amount of buffers which had to allocate
+		int Resize(const int& amount)
+		{
+			int allocations = 0;
+			for (auto& genes : Genes)
+				allocations += Telemetry::ResizeBuffer(genes, amount);
+			return allocations + Telemetry::ResizeBuffer(Qualities, amount) + Telemetry::ResizeBuffer(StepSizes, amount);
+		}
+
+		void Copy(const int& index, Population& target, const int& targetIndex) const
+		{
+			for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+				target.Genes[geneIndex][targetIndex] = Genes[geneIndex][index];
+			target.Qualities[targetIndex] = Qualities[index];
+			target.StepSizes[targetIndex] = StepSizes[index];
+		}
+	};
+
+	static int drawGene(RandomEngine& randomEngine, const int& min, const int& max) { return Random::Integer(randomEngine, min, max); }
+	static double drawGene(RandomEngine& randomEngine, const double& min, const double& max) { return Random::Real(randomEngine, min, max); }
+	static void fillGenes(int* outGenes, const int& amount, const int& min, const int& max, RandomEngine& randomEngine) { Random::FillIntegers(outGenes, amount, min, max, randomEngine); }
+	static void fillGenes(double* outGenes, const int& amount, const double& min, const double& max, RandomEngine& randomEngine) { Random::FillReals(outGenes, amount, min, max, randomEngine); }
+	//integer genes move by the rounded step
+	static void addStep(int& gene, const double& step) { gene += static_cast<int>(std::lround(step)); }
+	static void addStep(double& gene, const double& step) { gene += step; }
+
+	bool isSelfAdaptive() const { return m_settings.InitialStepSize > 0; }
+
+	void createChildren()
+	{
+		const int mu = m_settings.Mu;
+		bool recombination = m_settings.Recombination != MuSlashRohSharpLambdaRecombination::None;
+		bool selfAdaptive = isSelfAdaptive();
+		//log-normal step size update with the learning rate 1/sqrt(n) of Schwefel
+		const double learningRate = 1.0 / std::sqrt(static_cast<double>(GenesAmount));
+		Population& population = m_populations[m_currentPopulation];
+		//recombination and mutation happen in the same pass per child, a recombining pass counts as crossover
+		TELEMETRY_PHASE(m_settings.Recorder, recombination ? TelemetryPhase::Crossover : TelemetryPhase::Mutation);
+
+		//the children are independent of each other, every worker creates its own range with its own random stream
+		m_threadPool.Run([&](int workerIndex)
+		{
+			int begin, end;
+			ThreadPool::GetWorkerRange(workerIndex, m_threadPool.GetThreadsAmount(), m_settings.Lambda, 1, begin, end);
+			RandomEngine& randomEngine = m_workerEngines[workerIndex];
+
+			//random numbers of the whole range, drawn in bulk
+			int* parentIndices = m_parentIndices.data() + begin;
+			Gene* mutations = m_mutations.data() + begin * GenesAmount;
+			if (!recombination)
+				Random::FillIndices(parentIndices, end - begin, mu, randomEngine);
+			if (selfAdaptive)
+				Random::FillNormals(m_normals.data() + begin * (GenesAmount + 1), (end - begin) * (GenesAmount + 1), randomEngine);
+			else
+				fillGenes(mutations, (end - begin) * GenesAmount, m_settings.MutationRandomRange[0], m_settings.MutationRandomRange[1], randomEngine);
+
+			//children are stored behind the parents
+			for (int child = mu + begin; child < mu + end; ++child, ++parentIndices, mutations += GenesAmount)
+			{
+				if (recombination)
+					population.StepSizes[child] = recombine(population, child, m_recombinationParents.data() + workerIndex * m_settings.Roh, randomEngine);
+				else
+				{
+					for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+						population.Genes[geneIndex][child] = population.Genes[geneIndex][*parentIndices];
+					population.StepSizes[child] = population.StepSizes[*parentIndices];
+				}
+
+				if (selfAdaptive)
+				{
+					//the step size mutates first, so a good gene change also passes on the step size which made it
+					const double* normals = m_normals.data() + (child - mu) * (GenesAmount + 1);
+					double stepSize = std::max(population.StepSizes[child] * std::exp(learningRate * normals[GenesAmount]), m_settings.MinStepSize);
+					population.StepSizes[child] = stepSize;
+					for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+						addStep(population.Genes[geneIndex][child], stepSize * normals[geneIndex]);
+				}
+				else
+				{
+					for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+						population.Genes[geneIndex][child] += mutations[geneIndex];
+				}
+			}
+		});
+	}
+
+	//returns the average step size of the parents which contributed genes
+	double recombine(Population& population, const int& child, int* randomParentsScratch, RandomEngine& randomEngine) const
+	{
+		const int mu = m_settings.Mu, roh = m_settings.Roh;
+		double stepSizesSum = 0;
+		if (m_settings.Recombination == MuSlashRohSharpLambdaRecombination::Combination)
+		{
+			Random::FillIndices(randomParentsScratch, roh, mu, randomEngine);
+			for (int p = 0; p < roh; ++p)
+				stepSizesSum += population.StepSizes[randomParentsScratch[p]];
+			for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+				population.Genes[geneIndex][child] = population.Genes[geneIndex][randomParentsScratch[Random::Index(randomEngine, roh)]];
+			return stepSizesSum / roh;
+		}
+		else if (m_settings.Recombination == MuSlashRohSharpLambdaRecombination::Melting)
+		{
+			Gene genesSum[GenesAmount] = {};
+			for (int p = 0; p < roh; ++p)
+			{
+				for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+				{
+					int parent = Random::Index(randomEngine, mu);
+					genesSum[geneIndex] += population.Genes[geneIndex][parent];
+					stepSizesSum += population.StepSizes[parent];
+				}
+			}
+			for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+				population.Genes[geneIndex][child] = genesSum[geneIndex] / roh;
+			return stepSizesSum / (roh * GenesAmount);
+		}
+		return 0;
+	}
+
+	bool evaluateAndReturnTrueIfSolutionFound(const int& begin, const int& end, GenomeType& outSolution)
+	{
+		TELEMETRY_PHASE(m_settings.Recorder, TelemetryPhase::Evaluation);
+		Population& population = m_populations[m_currentPopulation];
+		const Gene* genes[GenesAmount];
+		for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+			genes[geneIndex] = population.Genes[geneIndex].data();
+
+		int solutionIndex = ParallelEvaluator<GenomeType, Objective, Constraint, Evaluator>::Evaluate(genes, population.Qualities.data(), begin, end, m_objective, m_constraint, m_threadPool, m_workerSolutionIndices);
+		m_evaluationsAmount += end - begin;
+		TELEMETRY_COUNT(m_settings.Recorder, TelemetryCounter::FitnessEvaluations, end - begin);
+
+		if (solutionIndex < 0)
+			return false;
+		for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+			outSolution.Genes[geneIndex] = population.Genes[geneIndex][solutionIndex];
+		return true;
+	}
+
+	//writes the mu survivors into the parents of the other population and returns the best quality
+	Quality select(RandomEngine& randomEngine)
+	{
+		TELEMETRY_PHASE(m_settings.Recorder, TelemetryPhase::Selection);
+		Population& population = m_populations[m_currentPopulation];
+		Population& nextPopulation = m_populations[1 - m_currentPopulation];
+
+		//the qualities are already determined by the evaluation, the children follow the parents
+		int first = m_settings.PlusSelection ? 0 : m_settings.Mu;
+		int candidatesAmount = m_settings.Mu + m_settings.Lambda - first;
+		if (m_threadPool.GetThreadsAmount() > 1)
+			m_selection.SelectParallel(population.Qualities.data() + first, candidatesAmount, m_settings.Mu, m_threadPool, m_workerEngines, m_selectedIndices);
+		else
+			m_selection.Select(population.Qualities.data() + first, candidatesAmount, m_settings.Mu, randomEngine, m_selectedIndices);
+
+		//with less children than parents the best ones get repeated
+		for (int i = 0; i < m_settings.Mu; ++i)
+			population.Copy(first + m_selectedIndices[i % m_selectedIndices.size()], nextPopulation, i);
+		m_currentPopulation = 1 - m_currentPopulation;
+		TELEMETRY_COUNT(m_settings.Recorder, TelemetryCounter::Copies, m_settings.Mu);
+
+		return population.Qualities[first + m_selectedIndices[0]];
+	}
+
+	Settings m_settings;
+	ThreadPool& m_threadPool;
+	std::vector<RandomEngine>& m_workerEngines;
+	Objective m_objective;
+	Constraint m_constraint;
+
+	std::vector<int> m_workerSolutionIndices;
+	//random numbers of a whole generation, every worker fills the part of its own children
+	std::vector<int> m_parentIndices;
+	std::vector<Gene> m_mutations;
+	std::vector<double> m_normals; //one for the step size and one per gene of every child
+	std::vector<int> m_recombinationParents; //roh parent indices per worker
+	//parents [0, mu) and children [mu, mu + lambda) of the current population, the selection writes the survivors into the parents of the other one
+	Population m_populations[2];
+	int m_currentPopulation = 0;
+	TopSelection m_selection;
+	std::vector<int> m_selectedIndices;
+	long long m_evaluationsAmount = 0;
+};
@@ -0,0 +1,181 @@
+#include "QualityTraceWriter.h"
+#include "../Common/BufferAppend.h"
+#include <iostream>
+
+QualityTraceWriter::QualityTraceWriter()
+{
+}
+
+QualityTraceWriter::~QualityTraceWriter()
+{
+	Close();
+}
+
+bool QualityTraceWriter::Open(const std::string& path, const QualityTraceFormat::Enum& format, const int& decimation, ExportQueue& exportQueue)
+{
+	m_exportQueue = &exportQueue;
+	return Open(path, format, decimation, false);
+}
+
+bool QualityTraceWriter::Open(const std::string& path, const QualityTraceFormat::Enum& format, const int& decimation, const bool& useBackgroundThread)
+{
+	m_format = format;
+	m_decimation = decimation;
+	m_iteration = 0;
+	m_hasSkippedQuality = false;
+	if (m_format == QualityTraceFormat::None)
+		return true;
+
+	m_file = std::make_shared<std::ofstream>(path, m_format == QualityTraceFormat::Binary ? std::ios::out | std::ios::binary : std::ios::out);
+	if (!m_file->is_open())
+	{
+		std::cout << "ERROR: Could not save file '" << path.c_str() << "'!\n";
+		m_format = QualityTraceFormat::None;
+		m_exportQueue = nullptr;
+		return false;
+	}
+
+	m_buffer.reserve(m_bufferCapacity);
+	m_pendingBuffer.reserve(m_bufferCapacity);
+
+	if (m_format == QualityTraceFormat::Csv)
+	{
+		const char header[] = "Iteration;Quality\n";
+		m_buffer.insert(m_buffer.end(), header, header + sizeof(header) - 1);
+	}
+	else
+	{
+		const char magic[] = { 'Q', 'T', 'R', 'C' };
+		m_buffer.insert(m_buffer.end(), magic, magic + sizeof(magic));
+		appendRecord(1, m_decimation); //version and decimation
+	}
+
+	m_closing = false;
+	if (useBackgroundThread)
+		m_writerThread = std::thread(&QualityTraceWriter::writerLoop, this);
+	m_lastFlush = std::chrono::steady_clock::now();
+	return true;
+}
+
+void QualityTraceWriter::Add(const int& quality)
+{
+	if (m_format == QualityTraceFormat::None)
+		return;
+
+	int iteration = m_iteration++;
+	m_hasSkippedQuality = iteration % m_decimation != 0;
+	if (m_hasSkippedQuality)
+	{
+		m_lastSkippedQuality = quality;
+		return;
+	}
+	appendRecord(iteration, quality);
+
+	//the clock is read per record, so a slowly filling buffer still reaches the file within the flush interval
+	if (m_buffer.size() + 32 > m_bufferCapacity || std::chrono::steady_clock::now() - m_lastFlush >= m_flushInterval)
+		flushBuffer();
+}
+
+void QualityTraceWriter::Close()
+{
+	if (m_format == QualityTraceFormat::None)
+		return;
+
+	if (m_hasSkippedQuality)
+		appendRecord(m_iteration - 1, m_lastSkippedQuality);
+	flushBuffer();
+
+	if (m_writerThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_closing = true;
+		}
+		m_pendingCondition.notify_one();
+		m_writerThread.join();
+	}
+	//waiting export tasks keep the file open until they are done
+	if (!m_exportQueue)
+		m_file->close();
+	m_file.reset();
+	m_exportQueue = nullptr;
+	m_format = QualityTraceFormat::None;
+}
+
+void QualityTraceWriter::appendRecord(const int& iteration, const int& quality)
+{
+	if (m_format == QualityTraceFormat::Csv)
+	{
+		BufferAppend::Number(m_buffer, iteration);
+		m_buffer.push_back(';');
+		BufferAppend::Number(m_buffer, quality);
+		m_buffer.push_back('\n');
+	}
+	else
+	{
+		BufferAppend::LittleEndian(m_buffer, static_cast<unsigned>(iteration), 4);
+		BufferAppend::LittleEndian(m_buffer, static_cast<unsigned>(quality), 4);
+	}
+}
+
+void QualityTraceWriter::flushBuffer()
+{
+	m_lastFlush = std::chrono::steady_clock::now();
+	if (m_exportQueue)
+	{
+		if (m_buffer.empty())
+			return;
+		//std::function needs a copyable task, so the buffer is handed over in a shared_ptr
+		auto buffer = std::make_shared<std::vector<char>>(std::move(m_buffer));
+		std::shared_ptr<std::ofstream> file = m_file;
+		m_exportQueue->Push([file, buffer]() { return writeToFile(*file, *buffer); });
+		m_buffer = std::vector<char>();
+		m_buffer.reserve(m_bufferCapacity);
+		return;
+	}
+	if (!m_writerThread.joinable())
+	{
+		writeToFile(*m_file, m_buffer);
+		m_buffer.clear();
+		return;
+	}
+
+	//waits only if the writer thread is still busy with the previous buffer
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_writtenCondition.wait(lock, [this] { return m_pendingBuffer.empty(); });
+	m_pendingBuffer.swap(m_buffer);
+	lock.unlock();
+	m_pendingCondition.notify_one();
+}
+
+bool QualityTraceWriter::writeToFile(std::ofstream& file, const std::vector<char>& buffer)
+{
+	if (buffer.empty())
+		return true;
+	//flushed right away, so everything handed to the file survives a killed process
+	file.write(buffer.data(), buffer.size());
+	file.flush();
+	if (!file.good())
+	{
+		std::cerr << "ERROR: Could not write the quality trace!\n";
+		return false;
+	}
+	return true;
+}
+
+void QualityTraceWriter::writerLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_pendingCondition.wait(lock, [this] { return !m_pendingBuffer.empty() || m_closing; });
+		if (m_pendingBuffer.empty())
+			break;
+
+		lock.unlock();
+		writeToFile(*m_file, m_pendingBuffer);
+		lock.lock();
+		m_pendingBuffer.clear();
+		m_writtenCondition.notify_one();
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include "../Common/ExportQueue.h"
+
+namespace QualityTraceFormat
+{
+	enum Enum
+	{
+		None,
+		Csv, //"Iteration;Quality" lines
+		Binary //"QTRC", version and decimation as int32, then one int32 iteration and one int32 quality per record, little endian
+	};
+}
+
+//streams the best quality per iteration into a file while the solver runs, the memory stays at two fixed buffers however long the run is
+class QualityTraceWriter
+{
+public:
+	QualityTraceWriter();
+	~QualityTraceWriter();
+
+	//decimation k keeps every k-th iteration, the background thread takes the file writes off the solver thread
+	bool Open(const std::string& path, const QualityTraceFormat::Enum& format, const int& decimation, const bool& useBackgroundThread);
+	//the full buffers are written by the export queue, which is shared by many writers, the file is closed after the last of them
+	bool Open(const std::string& path, const QualityTraceFormat::Enum& format, const int& decimation, ExportQueue& exportQueue);
+	void Add(const int& quality);
+	//writes the last iteration even if the decimation skipped it
+	void Close();
+
+private:
+	void appendRecord(const int& iteration, const int& quality);
+	void flushBuffer();
+	static bool writeToFile(std::ofstream& file, const std::vector<char>& buffer);
+	void writerLoop();
+
+	static const size_t m_bufferCapacity = 1 << 20;
+	//a full buffer gets written anyway, this limits what a killed process loses when the buffer fills slowly
+	const std::chrono::seconds m_flushInterval = std::chrono::seconds(1);
+
+	QualityTraceFormat::Enum m_format = QualityTraceFormat::None;
+	int m_decimation = 1;
+	int m_iteration = 0;
+	int m_lastSkippedQuality = 0;
+	bool m_hasSkippedQuality = false;
+	std::chrono::steady_clock::time_point m_lastFlush;
+	std::shared_ptr<std::ofstream> m_file; //shared with the export tasks which are still waiting
+	std::vector<char> m_buffer;
+	ExportQueue* m_exportQueue = nullptr;
+
+	std::thread m_writerThread;
+	std::mutex m_mutex;
+	std::condition_variable m_pendingCondition;
+	std::condition_variable m_writtenCondition;
+	std::vector<char> m_pendingBuffer; //only touched by the writer thread while it isn't empty
+	bool m_closing = false;
+};
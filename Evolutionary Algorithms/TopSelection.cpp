@@ -0,0 +1,33 @@
+#include "TopSelection.h"
+#include <algorithm>
+
+int TopSelection::selectInRange(const int& begin, const int& end, const int& amount)
+{
+	int selectedAmount = std::min(amount, end - begin);
+	if (selectedAmount > 0 && selectedAmount < end - begin)
+		std::nth_element(m_candidates.begin() + begin, m_candidates.begin() + begin + selectedAmount - 1, m_candidates.begin() + end);
+	return selectedAmount;
+}
+
+int TopSelection::gatherPreselections(const int& qualitiesAmount, const std::vector<int>& preselectedAmounts)
+{
+	//every range starts behind the gathered ones so nothing gets overwritten
+	int workersAmount = static_cast<int>(preselectedAmounts.size());
+	int candidatesAmount = 0;
+	for (int workerIndex = 0; workerIndex < workersAmount; ++workerIndex)
+	{
+		int begin, end;
+		ThreadPool::GetWorkerRange(workerIndex, workersAmount, qualitiesAmount, 1, begin, end);
+		std::copy(m_candidates.begin() + begin, m_candidates.begin() + begin + preselectedAmounts[workerIndex], m_candidates.begin() + candidatesAmount);
+		candidatesAmount += preselectedAmounts[workerIndex];
+	}
+	return candidatesAmount;
+}
+
+void TopSelection::writeOrderedIndices(const int& selectedAmount, std::vector<int>& outIndices)
+{
+	std::sort(m_candidates.begin(), m_candidates.begin() + selectedAmount);
+	outIndices.resize(selectedAmount);
+	for (int i = 0; i < selectedAmount; ++i)
+		outIndices[i] = m_candidates[i].Index;
+}
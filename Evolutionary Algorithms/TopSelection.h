@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+#include <cstring>
+#include "../Common/RandomEngine.h"
+#include "../Common/ThreadPool.h"
+
+//finds the best qualities in O(n) with nth_element instead of sorting the whole population, equal qualities are ordered by a random key
+class TopSelection
+{
+public:
+	//indices of the amount lowest qualities of [0, qualitiesAmount), ordered best first
+	template<typename Quality>
+	void Select(const Quality* qualities, const int& qualitiesAmount, const int& amount, RandomEngine& randomEngine, std::vector<int>& outIndices)
+	{
+		if (m_candidates.size() < qualitiesAmount)
+			m_candidates.resize(qualitiesAmount);
+
+		fillCandidates(qualities, 0, qualitiesAmount, randomEngine);
+		int selectedAmount = selectInRange(0, qualitiesAmount, amount);
+		writeOrderedIndices(selectedAmount, outIndices);
+	}
+
+	//every worker preselects the best of its own range, only amount * workers candidates are left for the final selection
+	template<typename Quality>
+	void SelectParallel(const Quality* qualities, const int& qualitiesAmount, const int& amount, ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines, std::vector<int>& outIndices)
+	{
+		if (m_candidates.size() < qualitiesAmount)
+			m_candidates.resize(qualitiesAmount);
+
+		int workersAmount = threadPool.GetThreadsAmount();
+		m_preselectedAmounts.resize(workersAmount);
+		threadPool.Run([&](int workerIndex)
+		{
+			int begin, end;
+			ThreadPool::GetWorkerRange(workerIndex, workersAmount, qualitiesAmount, 1, begin, end);
+			fillCandidates(qualities, begin, end, workerEngines[workerIndex]);
+			m_preselectedAmounts[workerIndex] = selectInRange(begin, end, amount);
+		});
+
+		int candidatesAmount = gatherPreselections(qualitiesAmount, m_preselectedAmounts);
+		int selectedAmount = selectInRange(0, candidatesAmount, amount);
+		writeOrderedIndices(selectedAmount, outIndices);
+	}
+
+private:
+	struct Candidate
+	{
+		unsigned long long Key; //rank of the quality
+		unsigned TieBreaker; //random, only decides between equal qualities
+		int Index;
+
+		bool operator<(const Candidate& other) const { return Key < other.Key || (Key == other.Key && TieBreaker < other.TieBreaker); }
+	};
+
+	//unsigned keys in the same order as the qualities
+	static unsigned long long getRankKey(const int& quality) { return static_cast<unsigned>(quality) ^ 0x80000000u; }
+	static unsigned long long getRankKey(const double& quality)
+	{
+		//all 64 bits of the double, + 0.0 turns -0 into +0 so both are equal
+		double value = quality + 0.0;
+		unsigned long long bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return (bits & 0x8000000000000000ull) ? ~bits : bits | 0x8000000000000000ull;
+	}
+
+	template<typename Quality>
+	void fillCandidates(const Quality* qualities, const int& begin, const int& end, RandomEngine& randomEngine)
+	{
+		//one engine draw breaks the ties of two candidates
+		int i = begin;
+		for (; i + 1 < end; i += 2)
+		{
+			unsigned long long bits = randomEngine();
+			m_candidates[i] = { getRankKey(qualities[i]), static_cast<unsigned>(bits), i };
+			m_candidates[i + 1] = { getRankKey(qualities[i + 1]), static_cast<unsigned>(bits >> 32), i + 1 };
+		}
+		if (i < end)
+			m_candidates[i] = { getRankKey(qualities[i]), static_cast<unsigned>(randomEngine() >> 32), i };
+	}
+
+	//moves the amount best of [begin, end) to the front of the range and returns how many there are
+	int selectInRange(const int& begin, const int& end, const int& amount);
+	//moves the preselections of all workers to the front and returns how many there are
+	int gatherPreselections(const int& qualitiesAmount, const std::vector<int>& preselectedAmounts);
+	void writeOrderedIndices(const int& selectedAmount, std::vector<int>& outIndices);
+
+	std::vector<Candidate> m_candidates;
+	std::vector<int> m_preselectedAmounts; //per worker, every worker writes its own entry
+};
@@ -1,14 +1,60 @@
 #include "GeneticAlgorithm.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <chrono>
+#include <memory>
+#include <cstring>
+
+namespace
+{
+	//fitness in the upper and index in the lower half -> the maximum is the best individual, ties go to the higher index
+	unsigned long long packBestCandidate(const int& fitness, const int& index)
+	{
+		return (static_cast<unsigned long long>(static_cast<unsigned>(fitness) ^ 0x80000000u) << 32) | static_cast<unsigned>(index);
+	}
 
-GeneticAlgorithm::GeneticAlgorithm()
+	int unpackBestCandidateIndex(const unsigned long long& candidate)
+	{
+		return static_cast<int>(candidate & 0xFFFFFFFFu);
+	}
+}
+
+GeneticAlgorithm::GeneticAlgorithm(const int& threadsAmount, const unsigned long long& seed) : m_threadPool(threadsAmount)
 {
-	m_mersenneTwisterEngine = std::mt19937_64(m_randomDevice());
+	m_randomEngine = RandomEngine(seed);
+	m_workerEngines.resize(m_threadPool.GetThreadsAmount());
 }
 
 GeneticAlgorithm::~GeneticAlgorithm()
 {
 }
 
+void GeneticAlgorithm::SetConfig(const GAConfig& config)
+{
+	m_config = config;
+}
+
+const GAConfig& GeneticAlgorithm::GetConfig() const
+{
+	return m_config;
+}
+
+int GeneticAlgorithm::GetBestFitness() const
+{
+	return m_bestFitness;
+}
+
+long long GeneticAlgorithm::GetEvaluationsAmount() const
+{
+	return m_evaluationsAmount;
+}
+
+void GeneticAlgorithm::SetTelemetry(Telemetry* telemetry)
+{
+	m_telemetry = telemetry;
+}
+
 std::vector<int> GeneticAlgorithm::SolveNQueensPuzzle(const int& queensAmount, int& outNeededIterations, bool& outSuccess)
 {	
 	/*
@@ -22,29 +68,142 @@ std::vector<int> GeneticAlgorithm::SolveNQueensPuzzle(const int& queensAmount, i
 	* Ersetze Individuen der akt. Generation nach Ersetzungsschema
 	* } while Abbruchbedingung trifft nicht zu
 	*/
-	initalizeRandomDistributions(queensAmount);
-
-	m_population.Initialize(queensAmount, m_randomChromosomeGeneDistribution, m_mersenneTwisterEngine);
-	int maxIterations = 1000000;
+	//one independent random stream per worker
+	unsigned long long solveSeed = m_randomEngine();
+	for (int workerIndex = 0; workerIndex < m_workerEngines.size(); ++workerIndex)
+		Random::SeedStream(m_workerEngines[workerIndex], solveSeed, workerIndex);
+
+	auto startTime = std::chrono::steady_clock::now();
+	m_population.Recorder = m_telemetry;
+	m_population.Initialize(queensAmount, getPopulationSize(queensAmount), m_config, m_threadPool, m_workerEngines);
 	outNeededIterations = 0;
-	while(m_population.EvaluateFitness() < 0 && ++outNeededIterations <= maxIterations)
+	while((m_bestFitness = m_population.EvaluateFitness(m_threadPool)) < m_config.TargetFitness && ++outNeededIterations <= m_config.MaxIterations && !isTimeBudgetExceeded(startTime))
 	{
-		m_population.OnePointCrossoverWithWedding(m_randomChromosomeGeneDistribution, m_mersenneTwisterEngine);
-		m_population.Mutate(0.5f, m_randomChromosomeGeneDistribution, m_randomProbabilityDistirbution, m_mersenneTwisterEngine);
-		m_population.Selection(3, true, m_randomChromosomeGeneDistribution, m_mersenneTwisterEngine);
+		m_population.CrossoverWithWedding(m_threadPool, m_workerEngines);
+		m_population.Mutate(m_config.MutationProbability, m_threadPool, m_workerEngines);
+		m_population.Selection(m_config.TournamentSize, m_config.PreserveBestIndividual, m_threadPool, m_workerEngines);
+		TELEMETRY_END_GENERATION(m_telemetry);
 	}
-	outSuccess = outNeededIterations < maxIterations;
-	return m_population.BestIndividual->Genes;
+	outSuccess = m_bestFitness >= m_config.TargetFitness;
+	m_evaluationsAmount = m_population.EvaluationsAmount;
+	const int* bestGenes = m_population.Individuals[m_population.BestIndex].Genes;
+	return std::vector<int>(bestGenes, bestGenes + queensAmount);
 }
 
-GeneticAlgorithm::Individual& GeneticAlgorithm::Individual::operator=(const Individual& other)
+std::vector<int> GeneticAlgorithm::SolveNQueensPuzzleWithIslands(const int& queensAmount, const int& islandsAmount, const int& migrationInterval, const MigrationTopology::Enum& topology, int& outNeededIterations, bool& outSuccess, std::vector<IslandStatistics>& outIslandStatistics)
 {
-	Genes.resize(other.Genes.size());
-	for (int i = 0; i < Genes.size(); i++)
-		Genes[i] = other.Genes[i];
-	Fitness = other.Fitness;
-	Best = other.Best;
-	return *this;
+	std::vector<Population> islands(islandsAmount);
+	std::vector<RandomEngine> islandEngines(islandsAmount);
+	unsigned long long solveSeed = m_randomEngine();
+	for (int islandIndex = 0; islandIndex < islandsAmount; ++islandIndex)
+		Random::SeedStream(islandEngines[islandIndex], solveSeed, islandIndex);
+	outIslandStatistics.assign(islandsAmount, IslandStatistics());
+
+	/* -------------------------------- MIGRATION ROUTES -------------------------------- */
+	//mailbox [target * islandsAmount + source] exists for every route from source to target
+	std::vector<std::unique_ptr<MigrantMailbox>> mailboxes(islandsAmount * islandsAmount);
+	for (int source = 0; source < islandsAmount; ++source)
+	{
+		for (int target = 0; target < islandsAmount; ++target)
+		{
+			bool isRingNeighbour = target == (source + 1) % islandsAmount;
+			if (source != target && (topology == MigrationTopology::AllToAll || isRingNeighbour))
+				mailboxes[target * islandsAmount + source].reset(new MigrantMailbox(queensAmount));
+		}
+	}
+
+	std::atomic<int> solvedIsland(-1);
+	auto startTime = std::chrono::steady_clock::now();
+
+	auto evolveIsland = [&](int islandIndex)
+	{
+		Population& population = islands[islandIndex];
+		IslandStatistics& statistics = outIslandStatistics[islandIndex];
+		std::vector<RandomEngine> engine(1, islandEngines[islandIndex]);
+		ThreadPool singleThread(1);
+
+		IndividualArena immigrants;
+		immigrants.Resize(1, queensAmount);
+
+		population.Recorder = m_telemetry;
+		population.Initialize(queensAmount, getPopulationSize(queensAmount), m_config, singleThread, engine);
+		statistics.BestFitness = INT_MIN;
+		while (true)
+		{
+			int bestFitness = population.EvaluateFitness(singleThread);
+			if (bestFitness > statistics.BestFitness)
+			{
+				statistics.BestFitness = bestFitness;
+				statistics.LastImprovementGeneration = statistics.Generations;
+			}
+
+			if (bestFitness >= m_config.TargetFitness)
+			{
+				int noIsland = -1;
+				solvedIsland.compare_exchange_strong(noIsland, islandIndex);
+				statistics.Solved = true;
+				break;
+			}
+			if (solvedIsland.load(std::memory_order_relaxed) >= 0 || ++statistics.Generations > m_config.MaxIterations || isTimeBudgetExceeded(startTime))
+				break;
+
+			/* -------------------------------- MIGRATION -------------------------------- */
+			if (statistics.Generations % migrationInterval == 0)
+			{
+				for (int other = 0; other < islandsAmount; ++other)
+				{
+					auto& outgoing = mailboxes[other * islandsAmount + islandIndex];
+					if (outgoing && outgoing->Send(population.Individuals[population.BestIndex]))
+						++statistics.MigrantsSent;
+
+					auto& incoming = mailboxes[islandIndex * islandsAmount + other];
+					while (incoming && incoming->Receive(immigrants[0]))
+					{
+						++statistics.MigrantsReceived;
+						Individual immigrant = immigrants[0];
+						immigrant.CountCollisions();
+						immigrant.ResetFitness();
+						immigrant.EvaluateFitness();
+						++population.EvaluationsAmount;
+						if (population.AcceptImmigrant(immigrants, 0))
+							++statistics.MigrantsAccepted;
+					}
+				}
+			}
+
+			population.CrossoverWithWedding(singleThread, engine);
+			population.Mutate(m_config.MutationProbability, singleThread, engine);
+			population.Selection(m_config.TournamentSize, m_config.PreserveBestIndividual, singleThread, engine);
+			TELEMETRY_END_GENERATION(m_telemetry);
+		}
+
+		statistics.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	};
+
+	//one thread per island
+	std::vector<std::thread> islandThreads;
+	for (int islandIndex = 0; islandIndex < islandsAmount; ++islandIndex)
+		islandThreads.emplace_back(evolveIsland, islandIndex);
+	for (auto& islandThread : islandThreads)
+		islandThread.join();
+
+	//the solving island or the best one if there is no solution
+	int resultIsland = solvedIsland.load();
+	outSuccess = resultIsland >= 0;
+	if (!outSuccess)
+	{
+		resultIsland = 0;
+		for (int islandIndex = 1; islandIndex < islandsAmount; ++islandIndex)
+			if (outIslandStatistics[islandIndex].BestFitness > outIslandStatistics[resultIsland].BestFitness)
+				resultIsland = islandIndex;
+	}
+	outNeededIterations = outIslandStatistics[resultIsland].Generations;
+	m_bestFitness = outIslandStatistics[resultIsland].BestFitness;
+	m_evaluationsAmount = 0;
+	for (auto& island : islands)
+		m_evaluationsAmount += island.EvaluationsAmount;
+	const int* bestGenes = islands[resultIsland].Individuals[islands[resultIsland].BestIndex].Genes;
+	return std::vector<int>(bestGenes, bestGenes + queensAmount);
 }
 
 void GeneticAlgorithm::Individual::ResetFitness()
@@ -55,141 +214,537 @@ void GeneticAlgorithm::Individual::ResetFitness()
 void GeneticAlgorithm::Individual::Reset()
 {
 	Best = false;
-	for (int i = 0; i < Genes.size(); ++i)
+	for (int i = 0; i < GenesAmount; ++i)
 		Genes[i] = -1;
+	std::fill(ColumnOccupancy, ColumnOccupancy + GenesAmount, 0);
+	std::fill(DiagonalOccupancy, DiagonalOccupancy + 2 * GenesAmount - 1, 0);
+	std::fill(AntiDiagonalOccupancy, AntiDiagonalOccupancy + 2 * GenesAmount - 1, 0);
+	Collisions = 0;
 	ResetFitness();
 }
 
-void GeneticAlgorithm::Individual::Initialize(const int& queensAmount, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine)
+void GeneticAlgorithm::Individual::Initialize(RandomEngine& randomEngine)
 {
 	Reset();
-	Genes.resize(queensAmount);
 
-	for (auto& gene : Genes)
-		gene = randomChromosomeGeneDistribution(mersenneTwisterEngine);
+	for (int i = 0; i < GenesAmount; ++i)
+		Genes[i] = Random::Index(randomEngine, GenesAmount);
+
+	CountCollisions();
 }
 
-int GeneticAlgorithm::Individual::EvaluateFitness()
+void GeneticAlgorithm::Individual::InitializePermutation(RandomEngine& randomEngine)
 {
-	int numberOfCollisions = 0;
+	Reset();
+
+	//every column exactly once -> Fisher-Yates shuffle of the identity
+	for (int i = 0; i < GenesAmount; ++i)
+		Genes[i] = i;
+	for (int i = GenesAmount - 1; i > 0; --i)
+		std::swap(Genes[i], Genes[Random::Index(randomEngine, i + 1)]);
+
+	CountCollisions();
+}
 
+void GeneticAlgorithm::Individual::CountCollisions()
+{
+	std::fill(ColumnOccupancy, ColumnOccupancy + GenesAmount, 0);
+	std::fill(DiagonalOccupancy, DiagonalOccupancy + 2 * GenesAmount - 1, 0);
+	std::fill(AntiDiagonalOccupancy, AntiDiagonalOccupancy + 2 * GenesAmount - 1, 0);
+	Collisions = 0;
+
+	//every queen collides with all queens which are already placed on one of its lines
+	for (int geneIndex = 0; geneIndex < GenesAmount; ++geneIndex)
+		PlaceQueen(geneIndex, Genes[geneIndex]);
+}
+
+void GeneticAlgorithm::Individual::SetGene(const int& geneIndex, const int& value)
+{
+	if (Genes[geneIndex] == value)
+		return;
+
+	RemoveQueen(geneIndex, Genes[geneIndex]);
+	Genes[geneIndex] = value;
+	PlaceQueen(geneIndex, value);
+}
+
+void GeneticAlgorithm::Individual::SwapGenes(const int& geneIndex, const int& otherGeneIndex)
+{
+	int gene = Genes[geneIndex];
+	SetGene(geneIndex, Genes[otherGeneIndex]);
+	SetGene(otherGeneIndex, gene);
+}
+
+void GeneticAlgorithm::Individual::PlaceQueen(const int& row, const int& column)
+{
+	Collisions += ColumnOccupancy[column]++;
+	Collisions += DiagonalOccupancy[row - column + GenesAmount - 1]++;
+	Collisions += AntiDiagonalOccupancy[row + column]++;
+}
+
+void GeneticAlgorithm::Individual::RemoveQueen(const int& row, const int& column)
+{
+	Collisions -= --ColumnOccupancy[column];
+	Collisions -= --DiagonalOccupancy[row - column + GenesAmount - 1];
+	Collisions -= --AntiDiagonalOccupancy[row + column];
+}
+
+int GeneticAlgorithm::Individual::EvaluateFitness()
+{
 	//fitness already set?
 	if (Fitness <= 0)
 		return Fitness;
 
-	for (int geneIndex = Genes.size(); --geneIndex > 0;)
+	//the number of pairs of queens in the same column or diagonal is tracked by the occupancy counters
+	Fitness = -Collisions;
+	return Fitness;
+}
+
+void GeneticAlgorithm::Individual::OnePointCrossover(Individual inOutOther, RandomEngine& randomEngine)
+{
+	int crossoverPoint = Random::Index(randomEngine, GenesAmount);
+
+	//swapping the head or the tail results in the same pair of children -> swap the shorter part
+	int current = crossoverPoint * 2 < GenesAmount ? 0 : crossoverPoint;
+	int end = crossoverPoint * 2 < GenesAmount ? crossoverPoint : GenesAmount;
+
+	for (; current < end; ++current)
 	{
-		//iterate through pairs of queens
-		for (int otherGeneIndex = geneIndex; --otherGeneIndex >= 0;)
-		{
-			//horizontal distance between queens
-			int distance = abs(Genes[geneIndex] - Genes[otherGeneIndex]);
+		int gene = Genes[current];
+		SetGene(current, inOutOther.Genes[current]);
+		inOutOther.SetGene(current, gene);
+	}
+
+	ResetFitness();
+	inOutOther.ResetFitness();
+}
+
+void GeneticAlgorithm::Individual::Mutate(const float& probability, RandomEngine& randomEngine)
+{
+	if (Random::Probability(randomEngine) >= probability)
+		return;
+
+	do
+		SetGene(Random::Index(randomEngine, GenesAmount), Random::Index(randomEngine, GenesAmount));
+	while (Random::Probability(randomEngine) < probability);
+
+	ResetFitness();
+}
+
+void GeneticAlgorithm::Individual::PartiallyMappedCrossover(Individual inOutOther, int* scratch, RandomEngine& randomEngine)
+{
+	int begin = Random::Index(randomEngine, GenesAmount);
+	int end = Random::Index(randomEngine, GenesAmount);
+	if (begin > end)
+		std::swap(begin, end);
+
+	//gene positions of both parents
+	int* positions = scratch;
+	int* otherPositions = scratch + GenesAmount;
+	for (int i = 0; i < GenesAmount; ++i)
+	{
+		positions[Genes[i]] = i;
+		otherPositions[inOutOther.Genes[i]] = i;
+	}
+
+	//take over the segment of the other parent, the displaced genes move to the position of the taken gene
+	for (int i = begin; i <= end; ++i)
+	{
+		int gene = Genes[i];
+		int otherGene = inOutOther.Genes[i];
+		SwapGenes(i, positions[otherGene]);
+		inOutOther.SwapGenes(i, otherPositions[gene]);
+		std::swap(positions[gene], positions[otherGene]);
+		std::swap(otherPositions[gene], otherPositions[otherGene]);
+	}
+
+	ResetFitness();
+	inOutOther.ResetFitness();
+}
+
+void GeneticAlgorithm::Individual::OrderCrossover(Individual inOutOther, int* scratch, RandomEngine& randomEngine)
+{
+	int begin = Random::Index(randomEngine, GenesAmount);
+	int end = Random::Index(randomEngine, GenesAmount);
+	if (begin > end)
+		std::swap(begin, end);
+
+	int* child = scratch;
+	int* otherChild = scratch + GenesAmount;
+	int* inSegment = scratch + 2 * GenesAmount;
+	int* otherInSegment = scratch + 3 * GenesAmount;
+	std::fill(inSegment, inSegment + 2 * GenesAmount, 0);
+
+	//every child keeps the segment of its parent
+	for (int i = begin; i <= end; ++i)
+	{
+		child[i] = Genes[i];
+		otherChild[i] = inOutOther.Genes[i];
+		inSegment[Genes[i]] = 1;
+		otherInSegment[inOutOther.Genes[i]] = 1;
+	}
 
-			//count the number of pairs of queens in the same column or diagonal
-			if ((distance == 0) || (distance == geneIndex - otherGeneIndex))
-				numberOfCollisions++;
+	//the remaining genes follow in the order of the other parent, starting behind the segment
+	int position = (end + 1) % GenesAmount, otherPosition = position;
+	for (int k = 0; k < GenesAmount; ++k)
+	{
+		int i = (end + 1 + k) % GenesAmount;
+		if (!inSegment[inOutOther.Genes[i]])
+		{
+			child[position] = inOutOther.Genes[i];
+			position = (position + 1) % GenesAmount;
+		}
+		if (!otherInSegment[Genes[i]])
+		{
+			otherChild[otherPosition] = Genes[i];
+			otherPosition = (otherPosition + 1) % GenesAmount;
 		}
 	}
 
-	Fitness = -numberOfCollisions;
-	return Fitness;
+	for (int i = 0; i < GenesAmount; ++i)
+	{
+		SetGene(i, child[i]);
+		inOutOther.SetGene(i, otherChild[i]);
+	}
+
+	ResetFitness();
+	inOutOther.ResetFitness();
 }
 
-void GeneticAlgorithm::Individual::OnePointCrossover(Individual& inOutOther, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine)
+void GeneticAlgorithm::Individual::CycleCrossover(Individual inOutOther, int* scratch)
 {
-	int current = -1; //start on the bottom
-	int crossoverPoint = randomChromosomeGeneDistribution(mersenneTwisterEngine);
+	int* positions = scratch;
+	int* visited = scratch + GenesAmount;
+	std::fill(visited, visited + GenesAmount, 0);
+	for (int i = 0; i < GenesAmount; ++i)
+		positions[Genes[i]] = i;
+
+	//every second cycle of positions gets exchanged between the parents
+	bool exchangeCycle = false;
+	for (int start = 0; start < GenesAmount; ++start)
+	{
+		if (visited[start])
+			continue;
+
+		for (int i = start; !visited[i]; i = positions[inOutOther.Genes[i]])
+			visited[i] = 1;
 
-	while (++current < crossoverPoint)
-		std::swap(Genes[current], inOutOther.Genes[current]);
+		if (exchangeCycle)
+		{
+			for (int i = start; visited[i] == 1;)
+			{
+				int next = positions[inOutOther.Genes[i]];
+				visited[i] = 2;
+				int gene = Genes[i];
+				SetGene(i, inOutOther.Genes[i]);
+				inOutOther.SetGene(i, gene);
+				i = next;
+			}
+		}
+		exchangeCycle = !exchangeCycle;
+	}
 
 	ResetFitness();
 	inOutOther.ResetFitness();
 }
 
-void GeneticAlgorithm::Individual::Mutate(const float& probability, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, const std::uniform_real_distribution<>& randomProbabilityDistirbution, std::mt19937_64& mersenneTwisterEngine)
+void GeneticAlgorithm::Individual::SwapMutate(const float& probability, RandomEngine& randomEngine)
 {
-	if (randomProbabilityDistirbution(mersenneTwisterEngine) >= probability)
+	if (Random::Probability(randomEngine) >= probability)
 		return;
 
 	do
-		Genes[randomChromosomeGeneDistribution(mersenneTwisterEngine)] = randomChromosomeGeneDistribution(mersenneTwisterEngine);
-	while (randomProbabilityDistirbution(mersenneTwisterEngine) < probability);
+		SwapGenes(Random::Index(randomEngine, GenesAmount), Random::Index(randomEngine, GenesAmount));
+	while (Random::Probability(randomEngine) < probability);
 
 	ResetFitness();
 }
 
-void GeneticAlgorithm::Population::Initialize(const int& queensAmount, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine)
+void GeneticAlgorithm::Individual::InsertionMutate(const float& probability, RandomEngine& randomEngine)
 {
-	Individuals.resize(queensAmount);
-	SelectionTmpBuffer.resize(queensAmount);
+	if (Random::Probability(randomEngine) >= probability)
+		return;
 
-	for (auto& individual : Individuals)
-		individual.Initialize(queensAmount, randomChromosomeGeneDistribution, mersenneTwisterEngine);
+	do
+	{
+		//take a gene out and insert it somewhere else, the genes in between shift by one
+		int from = Random::Index(randomEngine, GenesAmount);
+		int to = Random::Index(randomEngine, GenesAmount);
+		int step = from < to ? 1 : -1;
+		for (int i = from; i != to; i += step)
+			SwapGenes(i, i + step);
+	}
+	while (Random::Probability(randomEngine) < probability);
+
+	ResetFitness();
 }
 
-int GeneticAlgorithm::Population::EvaluateFitness()
+int GeneticAlgorithm::IndividualArena::Resize(const int& individualsAmount, const int& genesAmount)
 {
-	Individual& bestIndividual = Individuals[0];
-	bestIndividual.EvaluateFitness();
+	GenesAmount = genesAmount;
+	OccupancyStride = genesAmount + 2 * (2 * genesAmount - 1);
+	return Telemetry::ResizeBuffer(Genes, individualsAmount * GenesAmount)
+		+ Telemetry::ResizeBuffer(Occupancy, individualsAmount * OccupancyStride)
+		+ Telemetry::ResizeBuffer(Collisions, individualsAmount)
+		+ Telemetry::ResizeBuffer(Fitness, individualsAmount)
+		+ Telemetry::ResizeBuffer(Best, individualsAmount);
+}
 
-	//evaluate remaining individuals and check if better
-	for (int i = 1; i < Individuals.size(); ++i)
-		if (Individuals[i].EvaluateFitness() >= bestIndividual.Fitness)
-			bestIndividual = Individuals[i];
+int GeneticAlgorithm::IndividualArena::Size() const
+{
+	return static_cast<int>(Fitness.size());
+}
 
-	BestIndividual = &bestIndividual;
-	BestIndividual->Best = true;
-	return bestIndividual.Fitness;
+GeneticAlgorithm::Individual GeneticAlgorithm::IndividualArena::operator[](const int& index)
+{
+	int* occupancy = &Occupancy[index * OccupancyStride];
+	return Individual{ &Genes[index * GenesAmount], occupancy, occupancy + GenesAmount, occupancy + GenesAmount + 2 * GenesAmount - 1, Collisions[index], Fitness[index], Best[index], GenesAmount };
 }
 
-void GeneticAlgorithm::Population::OnePointCrossoverWithWedding(const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine)
+void GeneticAlgorithm::IndividualArena::Copy(const int& index, IndividualArena& target, const int& targetIndex) const
 {
-	// one point crossover of pairs of individuals
-	for (int i = 0; i < Individuals.size(); i += 2)
-		if(!(Individuals[i].Best || Individuals[i + 1].Best))
-			Individuals[i].OnePointCrossover(Individuals[i + 1], randomChromosomeGeneDistribution, mersenneTwisterEngine);
+	std::memcpy(&target.Genes[targetIndex * GenesAmount], &Genes[index * GenesAmount], GenesAmount * sizeof(int));
+	std::memcpy(&target.Occupancy[targetIndex * OccupancyStride], &Occupancy[index * OccupancyStride], OccupancyStride * sizeof(int));
+	target.Collisions[targetIndex] = Collisions[index];
+	target.Fitness[targetIndex] = Fitness[index];
+	target.Best[targetIndex] = false;
 }
 
-void GeneticAlgorithm::Population::Mutate(const float& probability, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, const std::uniform_real_distribution<>& randomProbabilityDistirbution, std::mt19937_64& mersenneTwisterEngine)
+void GeneticAlgorithm::IndividualArena::Swap(IndividualArena& other)
 {
-	for (auto& individual : Individuals)
-		individual.Mutate(probability, randomChromosomeGeneDistribution, randomProbabilityDistirbution, mersenneTwisterEngine);
+	std::swap(GenesAmount, other.GenesAmount);
+	std::swap(OccupancyStride, other.OccupancyStride);
+	Genes.swap(other.Genes);
+	Occupancy.swap(other.Occupancy);
+	Collisions.swap(other.Collisions);
+	Fitness.swap(other.Fitness);
+	Best.swap(other.Best);
 }
 
-void GeneticAlgorithm::Population::Selection(int torunamentSize, bool preserveBestIndividual, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine)
+void GeneticAlgorithm::Population::Initialize(const int& queensAmount, const int& populationSize, const GAConfig& config, ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines)
 {
-	int i = Individuals.size();
+	TELEMETRY_PHASE(Recorder, TelemetryPhase::Initialization);
+	Encoding = config.Encoding;
+	Crossover = config.Crossover;
+	MutationOperator = config.Mutation;
+	EvaluationsAmount = 0;
+
+	//all memory of the generation loop gets allocated here
+	int allocations = Individuals.Resize(populationSize, queensAmount);
+	allocations += SelectionTmpBuffer.Resize(populationSize, queensAmount);
+	allocations += Telemetry::ResizeBuffer(TournamentContestants, populationSize * config.TournamentSize);
+	allocations += Telemetry::ResizeBuffer(WeddingOrder, populationSize);
+	for (int i = 0; i < populationSize; ++i)
+		WeddingOrder[i] = i;
+	if (Encoding == ChromosomeEncoding::Permutation)
+		allocations += Telemetry::ResizeBuffer(CrossoverScratch, threadPool.GetThreadsAmount() * 4 * queensAmount);
+	TELEMETRY_COUNT(Recorder, TelemetryCounter::Allocations, allocations);
+
+	threadPool.Run([&](int workerIndex)
+	{
+		int begin, end;
+		ThreadPool::GetWorkerRange(workerIndex, threadPool.GetThreadsAmount(), Individuals.Size(), 2, begin, end);
+		for (int i = begin; i < end; ++i)
+		{
+			if (Encoding == ChromosomeEncoding::Permutation)
+				Individuals[i].InitializePermutation(workerEngines[workerIndex]);
+			else
+				Individuals[i].Initialize(workerEngines[workerIndex]);
+		}
+	});
+}
 
-	if (preserveBestIndividual)
+int GeneticAlgorithm::Population::EvaluateFitness(ThreadPool& threadPool)
+{
+	TELEMETRY_PHASE(Recorder, TelemetryPhase::Evaluation);
+	std::atomic<unsigned long long> bestCandidate(0);
+	std::atomic<long long> computedAmount(0);
+
+	threadPool.Run([&](int workerIndex)
+	{
+		int begin, end;
+		ThreadPool::GetWorkerRange(workerIndex, threadPool.GetThreadsAmount(), Individuals.Size(), 2, begin, end);
+		if (begin == end)
+			return;
+		//only the individuals without a known fitness are evaluations, like in the evolution strategies
+		long long cachedAmount = std::count_if(&Individuals.Fitness[begin], &Individuals.Fitness[begin] + (end - begin), [](const int& fitness) { return fitness <= 0; });
+		computedAmount += end - begin - cachedAmount;
+		TELEMETRY_COUNT(Recorder, TelemetryCounter::FitnessEvaluations, end - begin - cachedAmount);
+		TELEMETRY_COUNT(Recorder, TelemetryCounter::CachedFitnessHits, cachedAmount);
+
+		//evaluate the individuals of this worker and check if better
+		int bestIndex = begin;
+		Individuals[begin].EvaluateFitness();
+		for (int i = begin + 1; i < end; ++i)
+			if (Individuals[i].EvaluateFitness() >= Individuals.Fitness[bestIndex])
+				bestIndex = i;
+
+		//merge with the other workers without a lock
+		unsigned long long candidate = packBestCandidate(Individuals.Fitness[bestIndex], bestIndex);
+		unsigned long long currentBest = bestCandidate.load();
+		while (candidate > currentBest && !bestCandidate.compare_exchange_weak(currentBest, candidate));
+	});
+
+	EvaluationsAmount += computedAmount.load();
+
+	//the best individual gets copied to the front, the duplicate keeps the selection pressure up
+	int bestIndex = unpackBestCandidateIndex(bestCandidate.load());
+	if (bestIndex != 0)
 	{
-		BestIndividual->Best = false;
-		SelectionTmpBuffer[--i] = *BestIndividual;
+		Individuals.Copy(bestIndex, Individuals, 0);
+		TELEMETRY_COUNT(Recorder, TelemetryCounter::Copies, 1);
 	}
 
-	while (--i >= 0)
-		SelectionTmpBuffer[i] = TournamentSelection(torunamentSize, randomChromosomeGeneDistribution, mersenneTwisterEngine);
+	BestIndex = 0;
+	Individuals.Best[BestIndex] = true;
+	return Individuals.Fitness[BestIndex];
+}
+
+void GeneticAlgorithm::Population::CrossoverWithWedding(ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines)
+{
+	TELEMETRY_PHASE(Recorder, TelemetryPhase::Crossover);
+	//the partners of every wedding are shuffled, the last one stays single for an odd population size
+	std::shuffle(WeddingOrder.begin(), WeddingOrder.end(), workerEngines[0]);
+	int couplesAmount = Individuals.Size() / 2;
+
+	threadPool.Run([&](int workerIndex)
+	{
+		int begin, end;
+		ThreadPool::GetWorkerRange(workerIndex, threadPool.GetThreadsAmount(), couplesAmount, 1, begin, end);
+		int* scratch = CrossoverScratch.empty() ? nullptr : &CrossoverScratch[workerIndex * 4 * Individuals.GenesAmount];
+		RandomEngine& engine = workerEngines[workerIndex];
+
+		// crossover of the couples, every individual is part of one couple at most
+		for (int couple = begin; couple < end; ++couple)
+		{
+			int i = WeddingOrder[2 * couple];
+			int partner = WeddingOrder[2 * couple + 1];
+			if (Individuals.Best[i] || Individuals.Best[partner])
+				continue;
+
+			if (Encoding == ChromosomeEncoding::Free)
+				Individuals[i].OnePointCrossover(Individuals[partner], engine);
+			else if (Crossover == PermutationCrossover::PartiallyMapped)
+				Individuals[i].PartiallyMappedCrossover(Individuals[partner], scratch, engine);
+			else if (Crossover == PermutationCrossover::Order)
+				Individuals[i].OrderCrossover(Individuals[partner], scratch, engine);
+			else if (Crossover == PermutationCrossover::Cycle)
+				Individuals[i].CycleCrossover(Individuals[partner], scratch);
+		}
+	});
+}
+
+void GeneticAlgorithm::Population::Mutate(const float& probability, ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines)
+{
+	TELEMETRY_PHASE(Recorder, TelemetryPhase::Mutation);
+	threadPool.Run([&](int workerIndex)
+	{
+		int begin, end;
+		ThreadPool::GetWorkerRange(workerIndex, threadPool.GetThreadsAmount(), Individuals.Size(), 2, begin, end);
+		for (int i = begin; i < end; ++i)
+		{
+			if (Encoding == ChromosomeEncoding::Free)
+				Individuals[i].Mutate(probability, workerEngines[workerIndex]);
+			else if (MutationOperator == PermutationMutation::Swap)
+				Individuals[i].SwapMutate(probability, workerEngines[workerIndex]);
+			else if (MutationOperator == PermutationMutation::Insertion)
+				Individuals[i].InsertionMutate(probability, workerEngines[workerIndex]);
+		}
+	});
+}
+
+void GeneticAlgorithm::Population::Selection(int torunamentSize, bool preserveBestIndividual, ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines)
+{
+	TELEMETRY_PHASE(Recorder, TelemetryPhase::Selection);
+	int amount = Individuals.Size();
+
+	if (preserveBestIndividual)
+		Individuals.Copy(BestIndex, SelectionTmpBuffer, --amount);
+	//every individual of the next generation is a copy
+	TELEMETRY_COUNT(Recorder, TelemetryCounter::Copies, Individuals.Size());
+
+	threadPool.Run([&](int workerIndex)
+	{
+		int begin, end;
+		ThreadPool::GetWorkerRange(workerIndex, threadPool.GetThreadsAmount(), amount, 2, begin, end);
+
+		//draw the contestants of all tournaments of this worker at once
+		int* contestants = TournamentContestants.data() + begin * torunamentSize;
+		Random::FillIndices(contestants, (end - begin) * torunamentSize, Individuals.Size(), workerEngines[workerIndex]);
 
-	Individuals.swap(SelectionTmpBuffer); //new parents
-	BestIndividual = nullptr;
+		//only the winner gets copied
+		for (int i = begin; i < end; ++i, contestants += torunamentSize)
+			Individuals.Copy(TournamentSelection(contestants, torunamentSize), SelectionTmpBuffer, i);
+	});
+
+	Individuals.Swap(SelectionTmpBuffer); //new parents
+	BestIndex = -1;
 }
 
-GeneticAlgorithm::Individual GeneticAlgorithm::Population::TournamentSelection(int torunamentSize, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine)
+int GeneticAlgorithm::Population::TournamentSelection(const int* contestants, int torunamentSize) const
 {
-	Individual bestIndividual = Individuals[randomChromosomeGeneDistribution(mersenneTwisterEngine)];
+	int bestIndex = *contestants;
 
 	while (--torunamentSize > 0)
 	{
-		Individual individual = Individuals[randomChromosomeGeneDistribution(mersenneTwisterEngine)];
+		int index = *++contestants;
 
-		if (individual.Fitness > bestIndividual.Fitness)
-			bestIndividual = individual;
+		if (Individuals.Fitness[index] > Individuals.Fitness[bestIndex])
+			bestIndex = index;
 	}
-	return bestIndividual;
+	return bestIndex;
+}
+
+bool GeneticAlgorithm::Population::AcceptImmigrant(const IndividualArena& immigrants, const int& immigrantIndex)
+{
+	//the front holds the best individual
+	int worstIndex = 1;
+	for (int i = 2; i < Individuals.Size(); ++i)
+		if (Individuals.Fitness[i] < Individuals.Fitness[worstIndex])
+			worstIndex = i;
+
+	if (worstIndex >= Individuals.Size() || immigrants.Fitness[immigrantIndex] <= Individuals.Fitness[worstIndex])
+		return false;
+
+	immigrants.Copy(immigrantIndex, Individuals, worstIndex);
+	TELEMETRY_COUNT(Recorder, TelemetryCounter::Copies, 1);
+	return true;
+}
+
+GeneticAlgorithm::MigrantMailbox::MigrantMailbox(const int& queensAmount) : Head(0), Tail(0)
+{
+	for (auto& slot : Slots)
+		slot.resize(queensAmount);
+}
+
+bool GeneticAlgorithm::MigrantMailbox::Send(const Individual& emigrant)
+{
+	unsigned head = Head.load(std::memory_order_relaxed);
+	if (head - Tail.load(std::memory_order_acquire) >= Capacity)
+		return false;
+
+	std::copy(emigrant.Genes, emigrant.Genes + emigrant.GenesAmount, Slots[head % Capacity].begin());
+	Head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+bool GeneticAlgorithm::MigrantMailbox::Receive(Individual outImmigrant)
+{
+	unsigned tail = Tail.load(std::memory_order_relaxed);
+	if (tail == Head.load(std::memory_order_acquire))
+		return false;
+
+	std::copy(Slots[tail % Capacity].begin(), Slots[tail % Capacity].end(), outImmigrant.Genes);
+	Tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+int GeneticAlgorithm::getPopulationSize(const int& queensAmount) const
+{
+	return m_config.PopulationSize > 0 ? m_config.PopulationSize : queensAmount;
 }
 
-void GeneticAlgorithm::initalizeRandomDistributions(const int& genes)
+bool GeneticAlgorithm::isTimeBudgetExceeded(const std::chrono::steady_clock::time_point& startTime) const
 {
-	m_randomChromosomeGeneDistribution = std::uniform_int_distribution<int>(0, genes-1);
-	m_randomProbabilityDistirbution = std::uniform_real_distribution<double>(0, 1);
+	return m_config.TimeBudgetSeconds > 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() >= m_config.TimeBudgetSeconds;
 }
@@ -1,52 +1,202 @@
 #pragma once
 #include <random>
+#include <atomic>
+#include <chrono>
+#include "../Common/ThreadPool.h"
+#include "../Common/RandomEngine.h"
+#include "../Common/Telemetry.h"
+
+namespace MigrationTopology
+{
+	enum Enum
+	{
+		Ring,
+		AllToAll
+	};
+}
+namespace ChromosomeEncoding
+{
+	enum Enum
+	{
+		Free, //any column per row, column collisions are possible
+		Permutation //every column exactly once, only diagonal collisions are possible
+	};
+}
+namespace PermutationCrossover
+{
+	enum Enum
+	{
+		PartiallyMapped,
+		Order,
+		Cycle
+	};
+}
+namespace PermutationMutation
+{
+	enum Enum
+	{
+		Swap,
+		Insertion
+	};
+}
+
+struct GAConfig
+{
+	int PopulationSize = 0; //0 -> one individual per queen
+	float MutationProbability = 0.5f;
+	int TournamentSize = 3;
+	int MaxIterations = 1000000;
+	double TimeBudgetSeconds = 0; //wall clock limit of one solve, 0 -> no limit
+	int TargetFitness = 0; //stop as soon as the best individual reaches this fitness, 0 is a solution
+	bool PreserveBestIndividual = true;
+	ChromosomeEncoding::Enum Encoding = ChromosomeEncoding::Free;
+	PermutationCrossover::Enum Crossover = PermutationCrossover::PartiallyMapped; //only used with ChromosomeEncoding::Permutation
+	PermutationMutation::Enum Mutation = PermutationMutation::Swap; //only used with ChromosomeEncoding::Permutation
+};
 
 class GeneticAlgorithm
 {
 public:
-	GeneticAlgorithm();
+	//the results are reproducible for the same seed and amount of threads
+	explicit GeneticAlgorithm(const int& threadsAmount = 1, const unsigned long long& seed = std::random_device()());
 	~GeneticAlgorithm();
 
+	void SetConfig(const GAConfig& config);
+	const GAConfig& GetConfig() const;
+	//fitness of the best individual of the last solve
+	int GetBestFitness() const;
+	//fitness computations of the last solve, individuals whose fitness was already known are not counted
+	long long GetEvaluationsAmount() const;
+	//records the phases and counters of the following solves, nullptr records nothing
+	void SetTelemetry(Telemetry* telemetry);
+
 	std::vector<int> SolveNQueensPuzzle(const int& queensAmount, int& outNeededIterations, bool& outSuccess);
 
+	struct IslandStatistics
+	{
+		int Generations = 0;
+		int BestFitness = 0;
+		int LastImprovementGeneration = 0;
+		int MigrantsSent = 0;
+		int MigrantsReceived = 0;
+		int MigrantsAccepted = 0; //received migrants which were better than the replaced individual
+		double Seconds = 0;
+		bool Solved = false;
+	};
+
+	//every island evolves its own population on its own thread and sends its best individual to its neighbours every migrationInterval generations
+	std::vector<int> SolveNQueensPuzzleWithIslands(const int& queensAmount, const int& islandsAmount, const int& migrationInterval, const MigrationTopology::Enum& topology, int& outNeededIterations, bool& outSuccess, std::vector<IslandStatistics>& outIslandStatistics);
+
 private:
-	struct Individual 
+	friend class GeneticAlgorithmBenchmark; //measures the operators of the generation loop on their own
+
+	//view on one individual inside the arena of its population
+	struct Individual
 	{
-		std::vector<int> Genes; // queen positions in rows
-		int Fitness; //number of collisions
-		bool Best;
+		int* Genes; // queen positions in rows
+		int* ColumnOccupancy; // queens per column
+		int* DiagonalOccupancy; // queens per diagonal, indexed by row - column + queensAmount - 1
+		int* AntiDiagonalOccupancy; // queens per anti-diagonal, indexed by row + column
+		int& Collisions; //pairs of queens sharing a column or diagonal, kept in sync with the occupancy counters
+		int& Fitness; //number of collisions
+		char& Best;
+		int GenesAmount;
 
-		Individual& operator=(const Individual& other);
 		void ResetFitness();
 		void Reset();
-		void Initialize(const int& queensAmount, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine);
+		void Initialize(RandomEngine& randomEngine);
+		void InitializePermutation(RandomEngine& randomEngine);
+		//recount all collisions from scratch in O(N)
+		void CountCollisions();
+		//move the queen of a row and update the collisions in O(1)
+		void SetGene(const int& geneIndex, const int& value);
+		//exchange two queens, the collisions change in O(1)
+		void SwapGenes(const int& geneIndex, const int& otherGeneIndex);
+		void PlaceQueen(const int& row, const int& column);
+		void RemoveQueen(const int& row, const int& column);
 		int EvaluateFitness();
-		void OnePointCrossover(Individual& inOutOther, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine);
-		void Mutate(const float& probability, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, const std::uniform_real_distribution<>& randomProbabilityDistirbution, std::mt19937_64& mersenneTwisterEngine);
+		void OnePointCrossover(Individual inOutOther, RandomEngine& randomEngine);
+		void Mutate(const float& probability, RandomEngine& randomEngine);
+
+		//permutation preserving operators, scratch holds 4 * GenesAmount ints
+		void PartiallyMappedCrossover(Individual inOutOther, int* scratch, RandomEngine& randomEngine);
+		void OrderCrossover(Individual inOutOther, int* scratch, RandomEngine& randomEngine);
+		void CycleCrossover(Individual inOutOther, int* scratch);
+		void SwapMutate(const float& probability, RandomEngine& randomEngine);
+		void InsertionMutate(const float& probability, RandomEngine& randomEngine);
 	};
 
-	struct Population 
+	//structure of arrays for all individuals of a population, individual i owns the genes [i * GenesAmount, (i + 1) * GenesAmount)
+	struct IndividualArena
 	{
-		std::vector<Individual> Individuals; 
-		std::vector<Individual> SelectionTmpBuffer;
-		Individual* BestIndividual;
+		int GenesAmount = 0;
+		int OccupancyStride = 0; // column, diagonal and anti-diagonal counters of one individual
+		std::vector<int> Genes;
+		std::vector<int> Occupancy;
+		std::vector<int> Collisions;
+		std::vector<int> Fitness;
+		std::vector<char> Best;
 
-		void Initialize(const int& queensAmount, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine);
-		int EvaluateFitness();
-		void OnePointCrossoverWithWedding(const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine);
-		void Mutate(const float& probability, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, const std::uniform_real_distribution<>& randomProbabilityDistirbution, std::mt19937_64& mersenneTwisterEngine);
+		//returns the amount of buffers which had to allocate
+		int Resize(const int& individualsAmount, const int& genesAmount);
+		int Size() const;
+		Individual operator[](const int& index);
+		//plain memcpy of genes and counters, the copy is never marked as best
+		void Copy(const int& index, IndividualArena& target, const int& targetIndex) const;
+		void Swap(IndividualArena& other);
+	};
+
+	struct Population
+	{
+		IndividualArena Individuals;
+		IndividualArena SelectionTmpBuffer;
+		std::vector<int> TournamentContestants; //indices of all tournaments of one selection, tournament i uses [i * torunamentSize, (i + 1) * torunamentSize)
+		std::vector<int> WeddingOrder; //shuffled every generation, individuals 2 * i and 2 * i + 1 of it are a couple
+		std::vector<int> CrossoverScratch; //4 * GenesAmount ints per worker for the permutation crossovers
+		int BestIndex = -1;
+		long long EvaluationsAmount = 0; //fitness computations since Initialize
+		ChromosomeEncoding::Enum Encoding = ChromosomeEncoding::Free;
+		PermutationCrossover::Enum Crossover = PermutationCrossover::PartiallyMapped;
+		PermutationMutation::Enum MutationOperator = PermutationMutation::Swap;
+		Telemetry* Recorder = nullptr; //every stage records its own time and counters
+
+		//every stage splits the population into one range per worker, each worker uses its own engine
+		void Initialize(const int& queensAmount, const int& populationSize, const GAConfig& config, ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines);
+		int EvaluateFitness(ThreadPool& threadPool);
+		void CrossoverWithWedding(ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines);
+		void Mutate(const float& probability, ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines);
 		//determin new children
-		void Selection(int torunamentSize, bool preserveBestIndividual, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine);
-		//find the best individual in a randomly choosen individuals tournament with torunamentSize rounds. a kind of survival of the fittest
-		Individual TournamentSelection(int torunamentSize, const std::uniform_int_distribution<>& randomChromosomeGeneDistribution, std::mt19937_64& mersenneTwisterEngine);
+		void Selection(int torunamentSize, bool preserveBestIndividual, ThreadPool& threadPool, std::vector<RandomEngine>& workerEngines);
+		//find the index of the best individual in a tournament of torunamentSize randomly choosen contestants, only fitness values are compared. a kind of survival of the fittest
+		int TournamentSelection(const int* contestants, int torunamentSize) const;
+		//replaces the worst individual with the evaluated immigrant if the immigrant is better
+		bool AcceptImmigrant(const IndividualArena& immigrants, const int& immigrantIndex);
+	};
+
+	//lock-free single producer / single consumer queue which carries the best individuals from one island to another
+	struct MigrantMailbox
+	{
+		static const unsigned Capacity = 4;
+		std::vector<int> Slots[Capacity];
+		std::atomic<unsigned> Head; //only written by the sending island
+		std::atomic<unsigned> Tail; //only written by the receiving island
+
+		explicit MigrantMailbox(const int& queensAmount);
+		//false if the mailbox is full, the migrant gets dropped then
+		bool Send(const Individual& emigrant);
+		bool Receive(Individual outImmigrant);
 	};
 
-	void initalizeRandomDistributions(const int& genes);
+	int getPopulationSize(const int& queensAmount) const;
+	bool isTimeBudgetExceeded(const std::chrono::steady_clock::time_point& startTime) const;
 
-	std::random_device m_randomDevice;
-	std::mt19937_64 m_mersenneTwisterEngine;
-	std::uniform_int_distribution<int> m_randomChromosomeGeneDistribution;
-	std::uniform_real_distribution<double> m_randomProbabilityDistirbution;
+	RandomEngine m_randomEngine;
+	std::vector<RandomEngine> m_workerEngines;
+	ThreadPool m_threadPool;
+	GAConfig m_config;
+	int m_bestFitness = 0;
+	long long m_evaluationsAmount = 0;
+	Telemetry* m_telemetry = nullptr;
 	Population m_population;
 };
 
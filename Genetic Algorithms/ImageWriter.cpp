@@ -0,0 +1,336 @@
+#include "ImageWriter.h"
+#include <iostream>
+#include <algorithm>
+
+namespace
+{
+	const unsigned adlerModulo = 65521;
+	//the largest amount of bytes whose adler sums fit into 32 bit before the modulo
+	const size_t adlerBlockSize = 5552;
+	//back references of deflate reach at most 32K back and copy 3 to 258 bytes
+	const size_t maxMatchDistance = 32768;
+	const size_t minMatchLength = 3;
+	const size_t maxMatchLength = 258;
+	const unsigned short lengthBases[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	const unsigned char lengthExtraBits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	const unsigned short distanceBases[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	const unsigned char distanceExtraBits[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	unsigned reverseBits(unsigned code, const int& length)
+	{
+		unsigned reversed = 0;
+		for (int bit = 0; bit < length; ++bit, code >>= 1)
+			reversed = (reversed << 1) | (code & 1);
+		return reversed;
+	}
+
+	//the codes of the fixed Huffman block, deflate writes them from the most significant bit, so they are stored reversed
+	struct FixedHuffmanTable
+	{
+		FixedHuffmanTable()
+		{
+			for (int symbol = 0; symbol < 288; ++symbol)
+			{
+				unsigned code;
+				int length;
+				if (symbol < 144)
+				{
+					code = 0x30 + symbol;
+					length = 8;
+				}
+				else if (symbol < 256)
+				{
+					code = 0x190 + symbol - 144;
+					length = 9;
+				}
+				else if (symbol < 280)
+				{
+					code = symbol - 256;
+					length = 7;
+				}
+				else
+				{
+					code = 0xC0 + symbol - 280;
+					length = 8;
+				}
+				LiteralCodes[symbol] = reverseBits(code, length);
+				LiteralLengths[symbol] = length;
+			}
+			for (int symbol = 0; symbol < 30; ++symbol)
+				DistanceCodes[symbol] = reverseBits(symbol, 5);
+		}
+
+		unsigned LiteralCodes[288];
+		int LiteralLengths[288];
+		unsigned DistanceCodes[30];
+	};
+
+	struct Crc32Table
+	{
+		Crc32Table()
+		{
+			for (unsigned i = 0; i < 256; ++i)
+			{
+				unsigned crc = i;
+				for (int bit = 0; bit < 8; ++bit)
+					crc = crc & 1 ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+				Values[i] = crc;
+			}
+		}
+
+		unsigned Values[256];
+	};
+
+	unsigned calculateCrc32(const unsigned char* data, const size_t& size, unsigned crc = 0xFFFFFFFFu)
+	{
+		static const Crc32Table table;
+		for (size_t i = 0; i < size; ++i)
+			crc = table.Values[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+		return crc;
+	}
+
+	void appendBigEndian(std::vector<unsigned char>& buffer, const unsigned& value)
+	{
+		buffer.push_back(static_cast<unsigned char>(value >> 24));
+		buffer.push_back(static_cast<unsigned char>(value >> 16));
+		buffer.push_back(static_cast<unsigned char>(value >> 8));
+		buffer.push_back(static_cast<unsigned char>(value));
+	}
+}
+
+const char* ImageFormat::GetFileExtension(const Enum& format)
+{
+	switch (format)
+	{
+	case Png: return ".png";
+	case Ppm: return ".ppm";
+	default: return "";
+	}
+}
+
+ImageWriter::ImageWriter()
+{
+}
+
+ImageWriter::~ImageWriter()
+{
+	if (m_file.is_open())
+		m_file.close();
+}
+
+bool ImageWriter::Open(const std::string& path, const ImageFormat::Enum& format, const int& width, const int& height)
+{
+	m_format = format;
+	m_path = path;
+	m_width = width;
+	m_height = height;
+	m_writtenRows = 0;
+	m_adlerA = 1;
+	m_adlerB = 0;
+	m_bitBuffer = 0;
+	m_bitsAmount = 0;
+	if (m_format == ImageFormat::None)
+		return true;
+
+	m_file.open(path, std::ios::out | std::ios::binary);
+	if (!m_file.is_open())
+	{
+		std::cerr << "ERROR: Could not save file '" << path << "'!\n";
+		m_format = ImageFormat::None;
+		return false;
+	}
+
+	m_buffer.reserve(m_bufferCapacity);
+	if (m_format == ImageFormat::Ppm)
+	{
+		m_file << "P6\n" << m_width << " " << m_height << "\n255\n";
+		return m_file.good();
+	}
+
+	const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	m_file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+	std::vector<unsigned char> header;
+	appendBigEndian(header, m_width);
+	appendBigEndian(header, m_height);
+	const unsigned char bitDepth = 8, colorType = 6, compression = 0, filter = 0, interlace = 0;
+	header.insert(header.end(), { bitDepth, colorType, compression, filter, interlace });
+	writePngChunk("IHDR", header.data(), header.size());
+
+	//zlib header, deflate with a 32K window, the fastest level and no preset dictionary
+	const unsigned char zlibHeader[] = { 0x78, 0x01 };
+	writePngChunk("IDAT", zlibHeader, sizeof(zlibHeader));
+	return m_file.good();
+}
+
+bool ImageWriter::WriteRows(const RgbaColor* pixels, const int& rowsAmount)
+{
+	if (m_format == ImageFormat::None)
+		return true;
+	if (m_writtenRows + rowsAmount > m_height)
+	{
+		std::cerr << "ERROR: More rows than the image '" << m_path << "' has!\n";
+		return false;
+	}
+
+	//every row needs its filter type byte in png
+	const size_t rowBytes = m_format == ImageFormat::Png ? 1 + 4 * static_cast<size_t>(m_width) : 3 * static_cast<size_t>(m_width);
+	const int rowsPerBuffer = static_cast<int>(std::max<size_t>(1, m_bufferCapacity / rowBytes));
+	for (int firstRow = 0; firstRow < rowsAmount; firstRow += rowsPerBuffer)
+	{
+		int endRow = std::min(firstRow + rowsPerBuffer, rowsAmount);
+		m_buffer.resize((endRow - firstRow) * rowBytes);
+		unsigned char* bytes = m_buffer.data();
+		for (int y = firstRow; y < endRow; ++y)
+		{
+			const RgbaColor* row = pixels + static_cast<size_t>(y) * m_width;
+			if (m_format == ImageFormat::Png)
+			{
+				*bytes++ = 0; //no filter
+				std::copy(reinterpret_cast<const unsigned char*>(row), reinterpret_cast<const unsigned char*>(row + m_width), bytes);
+				bytes += 4 * static_cast<size_t>(m_width);
+			}
+			else
+			{
+				for (int x = 0; x < m_width; ++x)
+				{
+					*bytes++ = row[x].R;
+					*bytes++ = row[x].G;
+					*bytes++ = row[x].B;
+				}
+			}
+		}
+
+		if (m_format == ImageFormat::Png)
+		{
+			updateAdler32(m_buffer.data(), m_buffer.size());
+			writeCompressedBlock(m_buffer.data(), m_buffer.size(), rowBytes);
+		}
+		else
+			m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+	}
+	m_writtenRows += rowsAmount;
+
+	if (!m_file.good())
+	{
+		std::cerr << "ERROR: Could not write file '" << m_path << "'!\n";
+		return false;
+	}
+	return true;
+}
+
+bool ImageWriter::Close()
+{
+	if (m_format == ImageFormat::None)
+		return true;
+
+	if (m_format == ImageFormat::Png)
+	{
+		//an empty final block ends the deflate stream, its end of block code is seven zero bits
+		m_chunk.clear();
+		writeBits(3, 3);
+		writeBits(0, 7);
+		if (m_bitsAmount > 0)
+			writeBits(0, 8 - m_bitsAmount);
+		appendBigEndian(m_chunk, (m_adlerB << 16) | m_adlerA);
+		writePngChunk("IDAT", m_chunk.data(), m_chunk.size());
+		writePngChunk("IEND", nullptr, 0);
+	}
+
+	bool success = m_file.good() && m_writtenRows == m_height;
+	m_file.close();
+	m_format = ImageFormat::None;
+	if (!success)
+		std::cerr << "ERROR: Image '" << m_path << "' is incomplete!\n";
+	return success;
+}
+
+void ImageWriter::writePngChunk(const char* type, const unsigned char* data, const size_t& size)
+{
+	unsigned char lengthAndType[8] = { static_cast<unsigned char>(size >> 24), static_cast<unsigned char>(size >> 16), static_cast<unsigned char>(size >> 8), static_cast<unsigned char>(size) };
+	std::copy(type, type + 4, lengthAndType + 4);
+	unsigned crc = calculateCrc32(lengthAndType + 4, 4);
+	crc = calculateCrc32(data, size, crc) ^ 0xFFFFFFFFu;
+
+	unsigned char crcBytes[4] = { static_cast<unsigned char>(crc >> 24), static_cast<unsigned char>(crc >> 16), static_cast<unsigned char>(crc >> 8), static_cast<unsigned char>(crc) };
+	m_file.write(reinterpret_cast<const char*>(lengthAndType), sizeof(lengthAndType));
+	m_file.write(reinterpret_cast<const char*>(data), size);
+	m_file.write(reinterpret_cast<const char*>(crcBytes), sizeof(crcBytes));
+}
+
+void ImageWriter::writeCompressedBlock(const unsigned char* data, const size_t& size, const size_t& rowBytes)
+{
+	static const FixedHuffmanTable table;
+	auto writeSymbol = [this](const int& symbol) { writeBits(table.LiteralCodes[symbol], table.LiteralLengths[symbol]); };
+
+	//one IDAT chunk per buffer with one fixed Huffman block, the bits of an unfinished byte go into the next chunk
+	m_chunk.clear();
+	writeBits(2, 3); //not the final block, fixed Huffman codes
+
+	//the squares are filled with one color, so the previous pixel and the row above are the only matches worth looking for
+	//the back references stay in the buffer, the first row of a buffer only matches its previous pixel
+	const size_t distances[2] = { 4, rowBytes };
+	size_t i = 0;
+	while (i < size)
+	{
+		size_t bestLength = 0, bestDistance = 0;
+		for (size_t distance : distances)
+		{
+			if (distance > i || distance > maxMatchDistance)
+				continue;
+			size_t maxLength = std::min(maxMatchLength, size - i);
+			size_t length = 0;
+			while (length < maxLength && data[i + length] == data[i + length - distance])
+				++length;
+			if (length > bestLength)
+			{
+				bestLength = length;
+				bestDistance = distance;
+			}
+		}
+
+		if (bestLength < minMatchLength)
+		{
+			writeSymbol(data[i++]);
+			continue;
+		}
+
+		int lengthIndex = 28;
+		while (lengthBases[lengthIndex] > bestLength)
+			--lengthIndex;
+		writeSymbol(257 + lengthIndex);
+		writeBits(static_cast<unsigned>(bestLength - lengthBases[lengthIndex]), lengthExtraBits[lengthIndex]);
+		int distanceIndex = 29;
+		while (distanceBases[distanceIndex] > bestDistance)
+			--distanceIndex;
+		writeBits(table.DistanceCodes[distanceIndex], 5);
+		writeBits(static_cast<unsigned>(bestDistance - distanceBases[distanceIndex]), distanceExtraBits[distanceIndex]);
+		i += bestLength;
+	}
+	writeSymbol(256); //end of block
+	writePngChunk("IDAT", m_chunk.data(), m_chunk.size());
+}
+
+void ImageWriter::writeBits(const unsigned& bits, const int& bitsAmount)
+{
+	//deflate fills every byte from the least significant bit
+	m_bitBuffer |= static_cast<unsigned long long>(bits) << m_bitsAmount;
+	m_bitsAmount += bitsAmount;
+	for (; m_bitsAmount >= 8; m_bitsAmount -= 8, m_bitBuffer >>= 8)
+		m_chunk.push_back(static_cast<unsigned char>(m_bitBuffer));
+}
+
+void ImageWriter::updateAdler32(const unsigned char* data, const size_t& size)
+{
+	for (size_t offset = 0; offset < size; offset += adlerBlockSize)
+	{
+		size_t end = std::min(offset + adlerBlockSize, size);
+		for (size_t i = offset; i < end; ++i)
+		{
+			m_adlerA += data[i];
+			m_adlerB += m_adlerA;
+		}
+		m_adlerA %= adlerModulo;
+		m_adlerB %= adlerModulo;
+	}
+}
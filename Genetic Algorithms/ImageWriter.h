@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include "RasterImage.h"
+
+namespace ImageFormat
+{
+	enum Enum
+	{
+		None,
+		Png, //RGBA, deflate with the fixed Huffman codes and matches with the previous pixel or the row above
+		Ppm //binary RGB (P6), the alpha channel is dropped
+	};
+
+	const char* GetFileExtension(const Enum& format);
+}
+
+//writes an image row by row from top to bottom, only a small encoding buffer is needed however large the image is
+class ImageWriter
+{
+public:
+	ImageWriter();
+	~ImageWriter();
+
+	bool Open(const std::string& path, const ImageFormat::Enum& format, const int& width, const int& height);
+	bool WriteRows(const RgbaColor* pixels, const int& rowsAmount);
+	//fails if not all rows were written
+	bool Close();
+
+private:
+	void writePngChunk(const char* type, const unsigned char* data, const size_t& size);
+	void writeCompressedBlock(const unsigned char* data, const size_t& size, const size_t& rowBytes);
+	void writeBits(const unsigned& bits, const int& bitsAmount);
+	void updateAdler32(const unsigned char* data, const size_t& size);
+
+	static const size_t m_bufferCapacity = 1 << 20;
+
+	ImageFormat::Enum m_format = ImageFormat::None;
+	std::string m_path;
+	std::ofstream m_file;
+	int m_width = 0;
+	int m_height = 0;
+	int m_writtenRows = 0;
+	unsigned m_adlerA = 1;
+	unsigned m_adlerB = 0;
+	unsigned long long m_bitBuffer = 0; //bits of deflate which don't fill a byte yet
+	int m_bitsAmount = 0;
+	std::vector<unsigned char> m_buffer;
+	std::vector<unsigned char> m_chunk;
+};
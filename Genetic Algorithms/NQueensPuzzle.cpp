@@ -1,9 +1,11 @@
 #include "NQueensPuzzle.h"
-#include <SFML/Graphics/VertexArray.hpp>
 #include <iostream>
-#include "GeneticAlgorithm.h"
+#include <algorithm>
+#include <chrono>
+#include "../Common/BatchRunner.h"
+#include "../Common/ExportQueue.h"
 
-NQueensPuzzle::NQueensPuzzle() : m_queensAmount(0), m_pixelAmount(0)
+NQueensPuzzle::NQueensPuzzle() : m_queensAmount(0), m_threadsAmount(1), m_islandsAmount(1), m_migrationInterval(50), m_migrationTopology(MigrationTopology::Ring), m_seed(std::random_device()()), m_runsAmount(1), m_jobsAmount(1), m_statsInterval(0), m_imageFormat(ImageFormat::Png), m_resultFormat(ResultFormat::JsonLines), m_overviewPixel(0), m_exportRuns(false), m_exportQueueCapacity(4), m_pixelAmount(0)
 {
 }
 
@@ -17,28 +19,54 @@ int NQueensPuzzle::Execute(int argc, char** argv)
 	if (!parseCommandLine(argc, argv))
 		return 0;
 
-	std::cout << "INFO: Start solving '" + std::to_string(m_queensAmount) + " Queens Puzzle'\n";
+	if (m_runsAmount > 1)
+		return solveBatch() ? 1 : 0;
+
+	std::cout << "INFO: Start solving '" + std::to_string(m_queensAmount) + " Queens Puzzle' with seed " + std::to_string(m_seed) + "\n";
 	PuzzleResult result;
-	result.Positions.resize(m_queensAmount);
-	if (!solvePuzzle(result))
+	result.Seed = m_seed;
+	bool solved = solvePuzzle(result);
+	if (m_resultFormat != ResultFormat::None)
+	{
+		TELEMETRY_PHASE(&m_telemetry, TelemetryPhase::IO);
+		ResultWriter resultWriter;
+		if (!resultWriter.Open(getResultFileName(), m_resultFormat, "NQueensPuzzle", getRunParameters()) || !resultWriter.Write(createRunRecord(result)) || !resultWriter.Close())
+		{
+			std::cerr << "ERROR: Couldn't save result on filesystem! :(\n";
+			return 0;
+		}
+		std::cout << "INFO: Result saved in '" + getResultFileName() + "'\n";
+	}
+	if (!solved)
 	{
 		std::cerr << "ERROR: Couldn't solve Puzzle! :(\n";
 		return 0;
 	}
 	std::cout << "INFO: Solved successfully!\n";
 
-	if(!createAndSaveResultTextureOnFileSystem(result))
 	{
-		std::cerr << "ERROR: Couldn't save result on filesystem! :(\n";
-		return 0;
+		TELEMETRY_PHASE(&m_telemetry, TelemetryPhase::IO);
+		std::string fileName;
+		if (!createAndSaveResultImageOnFileSystem(result, "", fileName))
+		{
+			std::cerr << "ERROR: Couldn't save result on filesystem! :(\n";
+			return 0;
+		}
+		if (m_imageFormat != ImageFormat::None)
+		{
+			std::cout << "INFO: Result of '" + std::to_string(m_queensAmount) + " Queens Puzzle' saved in execution path!\n";
+			std::cout << "INFO: Filename: '" + fileName + "'\n";
+		}
 	}
+	if (Telemetry::IsEnabled() && m_statsInterval > 0)
+		std::cout << Telemetry::FormatStatsLine(m_telemetry.GetSnapshot()) << "\n";
 	return 1;
 }
 
 bool NQueensPuzzle::parseCommandLine(int argc, char** argv)
 {
 	const unsigned requiredArgv = 2;
-	if (argc != requiredArgv + 1)
+	if (argc < requiredArgv + 1)
 	{
 		showUsage(argv[0]);
 		return false;
@@ -54,13 +82,181 @@ bool NQueensPuzzle::parseCommandLine(int argc, char** argv)
 		}
 		if ((arg == "-n") && (i + 1 < argc))
 			m_queensAmount = std::stoi(argv[++i]);
+		if ((arg == "-t" || arg == "--threads") && (i + 1 < argc))
+			m_threadsAmount = std::stoi(argv[++i]);
+		if ((arg == "-i" || arg == "--islands") && (i + 1 < argc))
+			m_islandsAmount = std::stoi(argv[++i]);
+		if ((arg == "-k" || arg == "--migration-interval") && (i + 1 < argc))
+			m_migrationInterval = std::stoi(argv[++i]);
+		if ((arg == "-p" || arg == "--population") && (i + 1 < argc))
+			m_config.PopulationSize = std::stoi(argv[++i]);
+		if ((arg == "-m" || arg == "--mutation-rate") && (i + 1 < argc))
+			m_config.MutationProbability = std::stof(argv[++i]);
+		if ((arg == "--tournament") && (i + 1 < argc))
+			m_config.TournamentSize = std::stoi(argv[++i]);
+		if ((arg == "--max-iterations") && (i + 1 < argc))
+			m_config.MaxIterations = std::stoi(argv[++i]);
+		if ((arg == "--time-budget") && (i + 1 < argc))
+			m_config.TimeBudgetSeconds = std::stod(argv[++i]);
+		if ((arg == "--target-fitness") && (i + 1 < argc))
+			m_config.TargetFitness = std::stoi(argv[++i]);
+		if ((arg == "--seed") && (i + 1 < argc))
+			m_seed = std::stoull(argv[++i]);
+		if ((arg == "--runs") && (i + 1 < argc))
+			m_runsAmount = std::stoi(argv[++i]);
+		if ((arg == "--jobs") && (i + 1 < argc))
+			m_jobsAmount = std::stoi(argv[++i]);
+		if ((arg == "--stats") && (i + 1 < argc))
+			m_statsInterval = std::stoi(argv[++i]);
+		if ((arg == "--topology") && (i + 1 < argc))
+		{
+			std::string topology = argv[++i];
+			if (topology == "ring")
+				m_migrationTopology = MigrationTopology::Ring;
+			else if (topology == "all")
+				m_migrationTopology = MigrationTopology::AllToAll;
+			else
+			{
+				std::cerr << "ERROR: Input Error! Unknown migration topology '" + topology + "'!\n";
+				return false;
+			}
+		}
+		if ((arg == "--encoding") && (i + 1 < argc))
+		{
+			std::string encoding = argv[++i];
+			if (encoding == "free")
+				m_config.Encoding = ChromosomeEncoding::Free;
+			else if (encoding == "permutation")
+				m_config.Encoding = ChromosomeEncoding::Permutation;
+			else
+			{
+				std::cerr << "ERROR: Input Error! Unknown encoding '" + encoding + "'!\n";
+				return false;
+			}
+		}
+		if ((arg == "--crossover") && (i + 1 < argc))
+		{
+			std::string crossover = argv[++i];
+			if (crossover == "pmx")
+				m_config.Crossover = PermutationCrossover::PartiallyMapped;
+			else if (crossover == "ox")
+				m_config.Crossover = PermutationCrossover::Order;
+			else if (crossover == "cx")
+				m_config.Crossover = PermutationCrossover::Cycle;
+			else
+			{
+				std::cerr << "ERROR: Input Error! Unknown crossover '" + crossover + "'!\n";
+				return false;
+			}
+		}
+		if ((arg == "--image") && (i + 1 < argc))
+		{
+			std::string format = argv[++i];
+			if (format == "png")
+				m_imageFormat = ImageFormat::Png;
+			else if (format == "ppm")
+				m_imageFormat = ImageFormat::Ppm;
+			else if (format == "none")
+				m_imageFormat = ImageFormat::None;
+			else
+			{
+				std::cerr << "ERROR: Input Error! Unknown image format '" + format + "'!\n";
+				return false;
+			}
+		}
+		if ((arg == "--result") && (i + 1 < argc))
+		{
+			std::string format = argv[++i];
+			if (format == "jsonl")
+				m_resultFormat = ResultFormat::JsonLines;
+			else if (format == "binary")
+				m_resultFormat = ResultFormat::Binary;
+			else if (format == "none")
+				m_resultFormat = ResultFormat::None;
+			else
+			{
+				std::cerr << "ERROR: Input Error! Unknown result format '" + format + "'!\n";
+				return false;
+			}
+		}
+		if ((arg == "--overview") && (i + 1 < argc))
+			m_overviewPixel = std::stoi(argv[++i]);
+		if (arg == "--export-runs")
+			m_exportRuns = true;
+		if ((arg == "--export-queue") && (i + 1 < argc))
+			m_exportQueueCapacity = std::stoi(argv[++i]);
+		if ((arg == "--mutation") && (i + 1 < argc))
+		{
+			std::string mutation = argv[++i];
+			if (mutation == "swap")
+				m_config.Mutation = PermutationMutation::Swap;
+			else if (mutation == "insertion")
+				m_config.Mutation = PermutationMutation::Insertion;
+			else
+			{
+				std::cerr << "ERROR: Input Error! Unknown mutation '" + mutation + "'!\n";
+				return false;
+			}
+		}
 	}
 
-	if(m_queensAmount <= 4 || m_queensAmount % 2 == 1)
+	if(m_queensAmount < 4)
+	{
+		std::cerr << "ERROR: Input Error! Give at least a number >= 4 for the amount of Queens with the parameter '-n <NUM>'!\n";
+		return false;
+	}
+	if (m_threadsAmount < 0)
 	{
-		std::cerr << "ERROR: Input Error! Give at least a number >= 4 which is dividable by 2 for the amount of Queens with the parameter '-n <NUM>'!\n";
+		std::cerr << "ERROR: Input Error! The amount of threads can't be negative!\n";
 		return false;
 	}
+	if (m_islandsAmount < 1 || m_migrationInterval < 1)
+	{
+		std::cerr << "ERROR: Input Error! The amount of islands and the migration interval need to be positive numbers!\n";
+		return false;
+	}
+	if (m_config.PopulationSize < 0)
+	{
+		std::cerr << "ERROR: Input Error! The population size can't be negative, 0 uses one individual per queen!\n";
+		return false;
+	}
+	if (m_config.MutationProbability < 0 || m_config.MutationProbability > 1)
+	{
+		std::cerr << "ERROR: Input Error! The mutation rate needs to be between 0 and 1!\n";
+		return false;
+	}
+	if (m_config.TournamentSize < 1 || m_config.MaxIterations < 1 || m_config.TimeBudgetSeconds < 0)
+	{
+		std::cerr << "ERROR: Input Error! The tournament size and the maximum iterations need to be positive numbers, the time budget can't be negative!\n";
+		return false;
+	}
+	if (m_runsAmount < 1 || m_jobsAmount < 0)
+	{
+		std::cerr << "ERROR: Input Error! The amount of runs needs to be a positive number, the amount of jobs can't be negative!\n";
+		return false;
+	}
+	if (m_config.TargetFitness > 0)
+	{
+		std::cerr << "ERROR: Input Error! The fitness is the negative amount of collisions, the target fitness can't be positive!\n";
+		return false;
+	}
+	if (m_statsInterval < 0)
+	{
+		std::cerr << "ERROR: Input Error! The stats interval can't be negative!\n";
+		return false;
+	}
+	if (m_exportQueueCapacity < 1)
+	{
+		std::cerr << "ERROR: Input Error! The export queue needs space for at least one image!\n";
+		return false;
+	}
+	if (m_overviewPixel < 0)
+	{
+		std::cerr << "ERROR: Input Error! The overview size can't be negative, 0 saves the image in full resolution!\n";
+		return false;
+	}
+	if (m_statsInterval > 0 && !Telemetry::IsEnabled())
+		std::cout << "INFO: Built without SOLVER_TELEMETRY, --stats prints nothing\n";
 	return true;
 }
 
@@ -70,203 +266,375 @@ void NQueensPuzzle::showUsage(char* appExecutionPath)
 		<< "Options:\n"
 		<< "\t-h,--help\tShow this help message\n"
 		<< "\t-n <NUM>\tAmount of queens in puzzle.\n"
+		<< "\t-t,--threads <NUM>\tAmount of worker threads, 0 uses all hardware threads. Default: 1\n"
+		<< "\t-i,--islands <NUM>\tAmount of islands, every island evolves on its own thread. Default: 1\n"
+		<< "\t-k,--migration-interval <NUM>\tGenerations between two migrations of the best individuals. Default: 50\n"
+		<< "\t-p,--population <NUM>\tAmount of individuals, 0 uses one per queen. Default: 0\n"
+		<< "\t-m,--mutation-rate <NUM>\tProbability of one more mutation of an individual, between 0 and 1. Default: 0.5\n"
+		<< "\t--tournament <NUM>\tContestants per tournament of the selection. Default: 3\n"
+		<< "\t--max-iterations <NUM>\tGenerations until the search gives up. Default: 1000000\n"
+		<< "\t--time-budget <SECONDS>\tWall clock limit of the search, 0 is unlimited. Default: 0\n"
+		<< "\t--target-fitness <NUM>\tStop at this fitness (negative amount of collisions), 0 is a solution. Default: 0\n"
+		<< "\t--seed <NUM>\tSeed of the solver and the queen colors, the same seed and amount of threads reproduce a run. Default: random\n"
+		<< "\t--topology <ring|all>\tMigration to the next island or to all islands. Default: ring\n"
+		<< "\t--encoding <free|permutation>\tQueens anywhere in their row or every column exactly once. Default: free\n"
+		<< "\t--crossover <pmx|ox|cx>\tPartially mapped, order or cycle crossover for the permutation encoding. Default: pmx\n"
+		<< "\t--mutation <swap|insertion>\tSwap or insertion mutation for the permutation encoding. Default: swap\n"
+		<< "\t--image <png|ppm|none>\tFormat of the result image, ppm is written without any encoding. Default: png\n"
+		<< "\t--result <jsonl|binary|none>\tFormat of '<N>_queens_results' with the genome, fitness, iterations, evaluations, time, seed and parameters of every run. Default: jsonl\n"
+		<< "\t--overview <PIXELS>\tSave an image of at most PIXELS x PIXELS instead, every pixel averages a block of the full image. 0 saves the full resolution. Default: 0\n"
+		<< "\t--runs <NUM>\tIndependent runs with seeds derived from --seed, only a summary is printed and saved in '<N>_queens_batch.csv'. Default: 1\n"
+		<< "\t--jobs <NUM>\tRuns which are solved at the same time, 0 uses all hardware threads. Default: 1\n"
+		<< "\t--export-runs\tSave the image of every solved run of --runs as '<N>_queens_puzzle_run<RUN>', while the next runs are solved.\n"
+		<< "\t--export-queue <NUM>\tImages which may wait for the export, a full queue stops the runs until there's space again. Default: 4\n"
+		<< "\t--stats <NUM>\tPrint the time of every phase and the counters every NUM generations, with --runs only the totals of all runs at the end. Needs a build with SOLVER_TELEMETRY. Default: 0\n"
 		<< std::endl;
 }
 
 bool NQueensPuzzle::solvePuzzle(PuzzleResult& outResult)
 {
-	GeneticAlgorithm solver;
+	GeneticAlgorithm solver(ThreadPool::ResolveThreadsAmount(m_threadsAmount), m_seed);
+	solver.SetConfig(m_config);
+	if (m_statsInterval > 0)
+		m_telemetry.SetObserver(Telemetry::CreateStatsLinePrinter(m_statsInterval));
+	solver.SetTelemetry(&m_telemetry);
 	bool success;
-	std::vector<int> resultChromosome = solver.SolveNQueensPuzzle(m_queensAmount, outResult.NeededIterations, success);
-	if(success)
+	std::vector<int> resultChromosome;
+	auto startTime = std::chrono::steady_clock::now();
+	if (m_islandsAmount > 1)
 	{
-		for(int i = 0; i < m_queensAmount; ++i)
+		std::vector<GeneticAlgorithm::IslandStatistics> islandStatistics;
+		resultChromosome = solver.SolveNQueensPuzzleWithIslands(m_queensAmount, m_islandsAmount, m_migrationInterval, m_migrationTopology, outResult.NeededIterations, success, islandStatistics);
+		for (int i = 0; i < islandStatistics.size(); ++i)
 		{
-			outResult.Positions[i].y = i;
-			outResult.Positions[i].x = resultChromosome[i]; //gene
+			auto& statistics = islandStatistics[i];
+			std::cout << "INFO: Island " << i << (statistics.Solved ? " (solved)" : "")
+				<< ": generations " << statistics.Generations
+				<< ", best fitness " << statistics.BestFitness
+				<< " (since generation " << statistics.LastImprovementGeneration << ")"
+				<< ", migrants sent/received/accepted " << statistics.MigrantsSent << "/" << statistics.MigrantsReceived << "/" << statistics.MigrantsAccepted
+				<< ", " << statistics.Seconds << "s\n";
 		}
 	}
+	else
+		resultChromosome = solver.SolveNQueensPuzzle(m_queensAmount, outResult.NeededIterations, success);
+	outResult.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	std::cout << "INFO: " << outResult.NeededIterations << " iterations, best fitness " << solver.GetBestFitness() << "\n";
+	outResult.Solved = success;
+	outResult.BestFitness = solver.GetBestFitness();
+	outResult.EvaluationsAmount = solver.GetEvaluationsAmount();
+	setQueenPositions(resultChromosome, outResult);
 	return success;
 }
 
-bool NQueensPuzzle::createAndSaveResultTextureOnFileSystem(const PuzzleResult& puzzleResult)
+bool NQueensPuzzle::solveBatch()
 {
-	calculateResultTexturePixelWidthHeightAndDimension();
-	if (!createResultRenderTexture())
+	std::cout << "INFO: Start solving '" + std::to_string(m_queensAmount) + " Queens Puzzle' " + std::to_string(m_runsAmount) + " times with seed " + std::to_string(m_seed) + "\n";
+	BatchRunner batch(ThreadPool::ResolveThreadsAmount(m_jobsAmount));
+	//only the export thread draws, so it's the only one which touches the image members
+	ExportQueue exportQueue(m_exportQueueCapacity);
+	//the records are written by the export thread as well, in the order the runs finish
+	ResultWriter resultWriter;
+	if (!resultWriter.Open(getResultFileName(), m_resultFormat, "NQueensPuzzle", getRunParameters()))
 		return false;
+	std::vector<BatchRunResult> results;
+	//the parsed configuration is shared by all runs, every run only creates its own solver
+	batch.Run(m_runsAmount, [this, &exportQueue, &resultWriter](const int& runIndex, BatchRunResult& outResult)
+	{
+		outResult.Seed = Random::DeriveSeed(m_seed, runIndex);
+		GeneticAlgorithm solver(ThreadPool::ResolveThreadsAmount(m_threadsAmount), outResult.Seed);
+		solver.SetConfig(m_config);
+		//the runs add up their phases and counters, without an observer the lines of parallel runs can't interleave
+		solver.SetTelemetry(&m_telemetry);
+
+		int neededIterations = 0;
+		bool success = false;
+		std::vector<int> resultChromosome;
+		auto startTime = std::chrono::steady_clock::now();
+		if (m_islandsAmount > 1)
+		{
+			std::vector<GeneticAlgorithm::IslandStatistics> islandStatistics;
+			resultChromosome = solver.SolveNQueensPuzzleWithIslands(m_queensAmount, m_islandsAmount, m_migrationInterval, m_migrationTopology, neededIterations, success, islandStatistics);
+		}
+		else
+			resultChromosome = solver.SolveNQueensPuzzle(m_queensAmount, neededIterations, success);
+
+		outResult.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		outResult.Solved = success;
+		outResult.Iterations = neededIterations;
+		outResult.Quality = solver.GetBestFitness();
+
+		PuzzleResult puzzleResult;
+		puzzleResult.NeededIterations = neededIterations;
+		puzzleResult.Seed = outResult.Seed;
+		puzzleResult.Solved = success;
+		puzzleResult.BestFitness = solver.GetBestFitness();
+		puzzleResult.EvaluationsAmount = solver.GetEvaluationsAmount();
+		puzzleResult.Seconds = outResult.Seconds;
+		setQueenPositions(resultChromosome, puzzleResult);
+		if (m_resultFormat != ResultFormat::None)
+		{
+			RunRecord record = createRunRecord(puzzleResult);
+			record.Run = runIndex;
+			exportQueue.Push([&resultWriter, record]() { return resultWriter.Write(record); });
+		}
 
-	m_resultTexture.clear(sf::Color::White);
+		if (m_exportRuns && success && m_imageFormat != ImageFormat::None)
+		{
+			exportQueue.Push([this, puzzleResult, runIndex]()
+			{
+				std::string fileName;
+				return createAndSaveResultImageOnFileSystem(puzzleResult, "_run" + std::to_string(runIndex), fileName);
+			});
+		}
+	}, results);
 
-	drawGridInResultTextureAndCreateQueenPosLUT();
-	
-	if (!drawQueensInResultTexture(puzzleResult))
+	bool exported = exportQueue.Finish();
+	exported = resultWriter.Close() && exported;
+	BatchRunner::PrintSummary("BestFitness", results);
+	const std::string fileName = std::to_string(m_queensAmount) + "_queens_batch.csv";
+	if (!BatchRunner::WriteSummary(fileName, "BestFitness", results))
 		return false;
+	std::cout << "INFO: Summary saved in '" + fileName + "'\n";
+	//the results and the images share the export queue
+	if (!exported)
+	{
+		std::cerr << "ERROR: Couldn't save all results and images of the runs! :(\n";
+		return false;
+	}
+	if (m_resultFormat != ResultFormat::None)
+		std::cout << "INFO: Results of the runs saved in '" + getResultFileName() + "'\n";
+	if (m_exportRuns && m_imageFormat != ImageFormat::None)
+		std::cout << "INFO: Images of the solved runs saved as '" + std::to_string(m_queensAmount) + "_queens_puzzle_run<RUN>" + ImageFormat::GetFileExtension(m_imageFormat) + "'\n";
+	if (Telemetry::IsEnabled() && m_statsInterval > 0)
+		std::cout << Telemetry::FormatStatsLine(m_telemetry.GetSnapshot()) << "\n";
+	return true;
+}
+
+void NQueensPuzzle::setQueenPositions(const std::vector<int>& chromosome, PuzzleResult& outResult)
+{
+	outResult.Positions.resize(chromosome.size());
+	for (int i = 0; i < chromosome.size(); ++i)
+	{
+		outResult.Positions[i].Y = i;
+		outResult.Positions[i].X = chromosome[i]; //gene
+	}
+}
+
+std::string NQueensPuzzle::getResultFileName() const
+{
+	return std::to_string(m_queensAmount) + "_queens_results" + ResultFormat::GetFileExtension(m_resultFormat);
+}
+
+std::vector<RunParameter> NQueensPuzzle::getRunParameters() const
+{
+	const char* topologies[] = { "ring", "all" };
+	const char* encodings[] = { "free", "permutation" };
+	const char* crossovers[] = { "pmx", "ox", "cx" };
+	const char* mutations[] = { "swap", "insertion" };
+	std::vector<RunParameter> parameters;
+	parameters.push_back(RunParameter::Number("queens", m_queensAmount));
+	parameters.push_back(RunParameter::Number("seed", m_seed));
+	parameters.push_back(RunParameter::Number("runs", m_runsAmount));
+	parameters.push_back(RunParameter::Number("threads", m_threadsAmount));
+	parameters.push_back(RunParameter::Number("islands", m_islandsAmount));
+	parameters.push_back(RunParameter::Number("migrationInterval", m_migrationInterval));
+	parameters.push_back(RunParameter::Text("topology", topologies[m_migrationTopology]));
+	parameters.push_back(RunParameter::Number("population", m_config.PopulationSize));
+	parameters.push_back(RunParameter::Number("mutationRate", m_config.MutationProbability));
+	parameters.push_back(RunParameter::Number("tournament", m_config.TournamentSize));
+	parameters.push_back(RunParameter::Number("maxIterations", m_config.MaxIterations));
+	parameters.push_back(RunParameter::Number("timeBudget", m_config.TimeBudgetSeconds));
+	parameters.push_back(RunParameter::Number("targetFitness", m_config.TargetFitness));
+	parameters.push_back(RunParameter::Text("encoding", encodings[m_config.Encoding]));
+	parameters.push_back(RunParameter::Text("crossover", crossovers[m_config.Crossover]));
+	parameters.push_back(RunParameter::Text("mutation", mutations[m_config.Mutation]));
+	return parameters;
+}
+
+RunRecord NQueensPuzzle::createRunRecord(const PuzzleResult& puzzleResult)
+{
+	RunRecord record;
+	record.Seed = puzzleResult.Seed;
+	record.Solved = puzzleResult.Solved;
+	record.Iterations = puzzleResult.NeededIterations;
+	record.Evaluations = puzzleResult.EvaluationsAmount;
+	record.Seconds = puzzleResult.Seconds;
+	record.Fitness = puzzleResult.BestFitness;
+	//the column of the queen of every row
+	record.Genome.resize(puzzleResult.Positions.size());
+	for (int i = 0; i < puzzleResult.Positions.size(); ++i)
+		record.Genome[i] = puzzleResult.Positions[i].X;
+	return record;
+}
 
-	m_resultTexture.display();
+bool NQueensPuzzle::createAndSaveResultImageOnFileSystem(const PuzzleResult& puzzleResult, const std::string& fileNameSuffix, std::string& outFileName)
+{
+	if (m_imageFormat == ImageFormat::None)
+		return true;
+
+	calculateResultImagePixelWidthAndHeight();
+	createQueenPosLUT();
+	if (!createResultPrimitives(puzzleResult))
+		return false;
+
+	//the overview averages blocks of downsampling x downsampling pixels
+	int downsampling = m_overviewPixel > 0 ? (m_pixelAmount + m_overviewPixel - 1) / m_overviewPixel : 1;
+	int imagePixelAmount = (m_pixelAmount + downsampling - 1) / downsampling;
+	int stripRows = calculateStripRows(downsampling);
+	if (!createResultStrips(stripRows, downsampling))
+		return false;
+
+	outFileName = std::to_string(m_queensAmount) + "_queens_puzzle" + fileNameSuffix + (downsampling > 1 ? "_overview" : "") + ImageFormat::GetFileExtension(m_imageFormat);
+	ImageWriter writer;
+	if (!writer.Open(outFileName, m_imageFormat, imagePixelAmount, imagePixelAmount))
+		return false;
+
+	int workersAmount = std::max(1, std::min(ThreadPool::ResolveThreadsAmount(m_threadsAmount), stripRows / m_minRowsPerDrawWorker));
+	ThreadPool threadPool(workersAmount);
+	for (int stripFirstRow = 0; stripFirstRow < m_pixelAmount; stripFirstRow += stripRows)
+	{
+		int stripEndRow = std::min(stripFirstRow + stripRows, m_pixelAmount);
+		m_resultStrip.Resize(m_pixelAmount, stripEndRow - stripFirstRow, stripFirstRow);
+		if (downsampling > 1)
+			m_overviewStrip.Resize(imagePixelAmount, (stripEndRow - stripFirstRow + downsampling - 1) / downsampling, stripFirstRow / downsampling);
 
-	if (!saveResultTextureOnFileSystem())
+		//every worker draws everything clipped to its own rows, the image doesn't depend on the amount of workers
+		threadPool.Run([&](const int& workerIndex)
+		{
+			int firstRow, endRow;
+			ThreadPool::GetWorkerRange(workerIndex, workersAmount, stripEndRow - stripFirstRow, downsampling, firstRow, endRow);
+			firstRow += stripFirstRow;
+			endRow += stripFirstRow;
+			if (firstRow >= endRow)
+				return;
+
+			RasterView view = m_resultStrip.GetView(firstRow, endRow);
+			view.Clear(RgbaColor(255, 255, 255));
+			view.Draw(m_resultPrimitives);
+			if (downsampling > 1)
+				m_resultStrip.Downsample(downsampling, firstRow, endRow, m_overviewStrip);
+		});
+
+		const RasterImage& strip = downsampling > 1 ? m_overviewStrip : m_resultStrip;
+		if (!writer.WriteRows(strip.GetPixels(), strip.GetHeight()))
+			return false;
+	}
+	if (!writer.Close())
+	{
+		std::cerr << "ERROR: Result image creation failed!!\n";
 		return false;
+	}
 	return true;
 }
 
-bool NQueensPuzzle::createResultRenderTexture()
+bool NQueensPuzzle::createResultStrips(const int& stripRows, const int& downsampling)
 {
-	if (!m_resultTexture.create(m_textureDimension.x, m_textureDimension.y))
+	try
 	{
-		std::cerr << "ERROR: Cannot create rendertexture!";
+		m_resultStrip.Resize(m_pixelAmount, stripRows);
+		if (downsampling > 1)
+			m_overviewStrip.Resize((m_pixelAmount + downsampling - 1) / downsampling, (stripRows + downsampling - 1) / downsampling);
+	}
+	catch (const std::bad_alloc&)
+	{
+		std::cerr << "ERROR: Cannot allocate an image strip of " << m_pixelAmount << "x" << stripRows << " pixels!\n";
 		return false;
 	}
 	return true;
 }
 
-void NQueensPuzzle::calculateResultTexturePixelWidthHeightAndDimension()
+void NQueensPuzzle::calculateResultImagePixelWidthAndHeight()
 {
 	m_pixelAmount = (m_queensAmount * (m_queensPixel + m_gridPixel)) - m_gridPixel; // -gridPixel for the last one where no grid is needed
-	m_textureDimension = {m_pixelAmount, m_pixelAmount};
 }
 
-void NQueensPuzzle::drawGridInResultTextureAndCreateQueenPosLUT()
+int NQueensPuzzle::calculateStripRows(const int& downsampling) const
+{
+	//whole blocks of the overview per strip, at least one
+	size_t rowBytes = static_cast<size_t>(m_pixelAmount) * sizeof(RgbaColor);
+	int blocks = static_cast<int>(std::max<size_t>(1, m_maxStripBytes / (rowBytes * downsampling)));
+	return std::min(blocks * downsampling, m_pixelAmount);
+}
+
+void NQueensPuzzle::createQueenPosLUT()
 {
 	int queenPixelHalf = m_queensPixel / 2;
 
 	m_queenMiddlePointPixelXCoordLUT.resize(m_queensAmount);
 	m_queenMiddlePointPixelYCoordLUT.resize(m_queensAmount);
-	
-	sf::VertexArray vertices(sf::PrimitiveType::Lines);
-	for (int x = 0; x < m_queensAmount; ++x)
+	for (int i = 0; i < m_queensAmount; ++i)
 	{
-		int xPos = x * m_queensPixel + x * m_gridPixel;
-		sf::Vertex v1(sf::Vector2f(xPos, 0), sf::Color::Black);
-		sf::Vertex v2(sf::Vector2f(xPos, m_pixelAmount), sf::Color::Black);
-		vertices.append(v1);
-		vertices.append(v2);
-
-		m_queenMiddlePointPixelXCoordLUT[x] = xPos + queenPixelHalf;
-	}
-	for (int y = 0; y < m_queensAmount; ++y)
-	{
-		int yPos = y * m_queensPixel + y * m_gridPixel;
-		sf::Vertex v1(sf::Vector2f(0, yPos), sf::Color::Black);
-		sf::Vertex v2(sf::Vector2f(m_pixelAmount, yPos), sf::Color::Black);
-		vertices.append(v1);
-		vertices.append(v2);
-
-		m_queenMiddlePointPixelYCoordLUT[y] = yPos + queenPixelHalf + 1;
+		//the cell starts right after the grid line of the previous one
+		int cellPos = i * (m_queensPixel + m_gridPixel);
+		m_queenMiddlePointPixelXCoordLUT[i] = cellPos + queenPixelHalf;
+		m_queenMiddlePointPixelYCoordLUT[i] = cellPos + queenPixelHalf;
 	}
-	m_resultTexture.draw(vertices);
 }
 
-bool NQueensPuzzle::drawQueensInResultTexture(const PuzzleResult& puzzleResult)
+bool NQueensPuzzle::createResultPrimitives(const PuzzleResult& puzzleResult)
 {
 	int queenPixelHalf = m_queensPixel / 2;
-	for(int i = 0; i < puzzleResult.Positions.size(); ++i)
+	int lastIndex = m_queensAmount - 1;
+	m_resultPrimitives.clear();
+	m_resultPrimitives.reserve(2 * lastIndex + 5 * puzzleResult.Positions.size());
+
+	/* -------------------------------- GRID -------------------------------- */
+	const RgbaColor gridColor(0, 0, 0);
+	for (int i = 1; i < m_queensAmount; ++i)
+	{
+		int gridPos = i * (m_queensPixel + m_gridPixel) - m_gridPixel;
+		m_resultPrimitives.push_back({ RasterPrimitiveType::Rect, gridPos, 0, gridPos + m_gridPixel, m_pixelAmount, gridColor });
+		m_resultPrimitives.push_back({ RasterPrimitiveType::Rect, 0, gridPos, m_pixelAmount, gridPos + m_gridPixel, gridColor });
+	}
+
+	//the solver uses stream 0 of the seed
+	RandomEngine colorEngine;
+	Random::SeedStream(colorEngine, puzzleResult.Seed, 1);
+	for (int i = 0; i < puzzleResult.Positions.size(); ++i)
 	{
 		auto& queenPos = puzzleResult.Positions[i];
-		if (queenPos.x >= m_queensAmount || queenPos.y >= m_queensAmount)
+		if (queenPos.X < 0 || queenPos.Y < 0 || queenPos.X >= m_queensAmount || queenPos.Y >= m_queensAmount)
 		{
-			std::cerr << "ERROR: Queen position is out of texture range!";
+			std::cerr << "ERROR: Queen position is out of image range!\n";
 			return false;
 		}
 
-		sf::Vector2i queenMiddlePointPixelPos = { m_queenMiddlePointPixelXCoordLUT[queenPos.x], m_queenMiddlePointPixelYCoordLUT[queenPos.y] };
-
-		sf::Color queenColor = sf::Color::White;
+		RgbaColor queenColor(255, 255, 255);
 		//AVOID VERY BRIGHT OR VERY DARK COLORS!!
-		while(queenColor.r < 20 || queenColor.r > 220 || queenColor.g < 20 || queenColor.g > 220 || queenColor.b < 20 || queenColor.b > 220)
-			queenColor = sf::Color(rand() % 255, rand() % 255, rand() % 255);
+		while (queenColor.R < 20 || queenColor.R > 220 || queenColor.G < 20 || queenColor.G > 220 || queenColor.B < 20 || queenColor.B > 220)
+			queenColor = RgbaColor(Random::Index(colorEngine, 255), Random::Index(colorEngine, 255), Random::Index(colorEngine, 255));
+
+		int middleX = m_queenMiddlePointPixelXCoordLUT[queenPos.X];
+		int middleY = m_queenMiddlePointPixelYCoordLUT[queenPos.Y];
 
 		/* -------------------------------- QUEEN QUAD -------------------------------- */
-		{
-			sf::VertexArray vertices(sf::PrimitiveType::Quads, 4);
-			vertices[0] = { sf::Vector2f(queenMiddlePointPixelPos.x - queenPixelHalf, queenMiddlePointPixelPos.y + queenPixelHalf), queenColor }; // lower left
-			vertices[1] = { sf::Vector2f(queenMiddlePointPixelPos.x - queenPixelHalf, queenMiddlePointPixelPos.y - queenPixelHalf), queenColor }; // upper left
-			vertices[2] = { sf::Vector2f(queenMiddlePointPixelPos.x + queenPixelHalf, queenMiddlePointPixelPos.y - queenPixelHalf), queenColor }; // upper right
-			vertices[3] = { sf::Vector2f(queenMiddlePointPixelPos.x + queenPixelHalf, queenMiddlePointPixelPos.y + queenPixelHalf), queenColor }; // lower right
-			m_resultTexture.draw(vertices);
-		}
+		m_resultPrimitives.push_back({ RasterPrimitiveType::Rect, middleX - queenPixelHalf, middleY - queenPixelHalf, middleX + queenPixelHalf, middleY + queenPixelHalf, queenColor });
 
 		/* -------------------------------- VERTICAL LINE -------------------------------- */
-		{
-			sf::VertexArray vertices(sf::PrimitiveType::Lines, 2);
-			vertices[0] = { sf::Vector2f(queenMiddlePointPixelPos.x, 0), queenColor };
-			vertices[1] = { sf::Vector2f(queenMiddlePointPixelPos.x, m_pixelAmount), queenColor };
-			m_resultTexture.draw(vertices);
-		}
+		m_resultPrimitives.push_back({ RasterPrimitiveType::Rect, middleX, 0, middleX + 1, m_pixelAmount, queenColor });
 
 		/* -------------------------------- HORIZONTAL LINE -------------------------------- */
-		{
-			sf::VertexArray vertices(sf::PrimitiveType::Lines, 2);
-			vertices[0] = { sf::Vector2f(0, queenMiddlePointPixelPos.y), queenColor };
-			vertices[1] = { sf::Vector2f(m_pixelAmount, queenMiddlePointPixelPos.y), queenColor };
-			m_resultTexture.draw(vertices);
-		}
+		m_resultPrimitives.push_back({ RasterPrimitiveType::Rect, 0, middleY, m_pixelAmount, middleY + 1, queenColor });
 
 		/* -------------------------------- DIAGONAL LEFT UP LINE -------------------------------- */
 		{
-			//quick and dirty solution
-			sf::Vector2i upperLeft = queenPos;
-			for (int x = 0; x < m_queensAmount; ++x)
-			{
-				if (upperLeft.x <= 0 || upperLeft.y <= 0)
-					break;
-				--upperLeft.x;
-				--upperLeft.y;
-			}
-
-			sf::Vector2i lowerRight = queenPos;
-			for (int x = 0; x < m_queensAmount; ++x)
-			{
-				if (lowerRight.x >= m_queensAmount - 1 || lowerRight.y >= m_queensAmount - 1)
-					break;
-				++lowerRight.x;
-				++lowerRight.y;
-			}
-
-			sf::VertexArray vertices(sf::PrimitiveType::Lines, 2);
-			vertices[0] = { sf::Vector2f(m_queenMiddlePointPixelXCoordLUT[upperLeft.x] - queenPixelHalf, m_queenMiddlePointPixelYCoordLUT[upperLeft.y] - queenPixelHalf), queenColor };
-			vertices[1] = { sf::Vector2f(m_queenMiddlePointPixelXCoordLUT[lowerRight.x] + queenPixelHalf, m_queenMiddlePointPixelYCoordLUT[lowerRight.y] + queenPixelHalf), queenColor };
-			m_resultTexture.draw(vertices);
+			//the diagonal ends at the board border which is reached first
+			int stepsUp = std::min(queenPos.X, queenPos.Y);
+			int stepsDown = std::min(lastIndex - queenPos.X, lastIndex - queenPos.Y);
+			m_resultPrimitives.push_back({ RasterPrimitiveType::Line,
+				m_queenMiddlePointPixelXCoordLUT[queenPos.X - stepsUp] - queenPixelHalf, m_queenMiddlePointPixelYCoordLUT[queenPos.Y - stepsUp] - queenPixelHalf,
+				m_queenMiddlePointPixelXCoordLUT[queenPos.X + stepsDown] + queenPixelHalf, m_queenMiddlePointPixelYCoordLUT[queenPos.Y + stepsDown] + queenPixelHalf, queenColor });
 		}
 
 		/* -------------------------------- DIAGONAL RIGHT UP LINE -------------------------------- */
 		{
-			//quick and dirty solution
-			sf::Vector2i lowerLeft = queenPos;
-			for (int x = 0; x < m_queensAmount; ++x)
-			{
-				if (lowerLeft.x <= 0 || lowerLeft.y >= m_queensAmount - 1)
-					break;
-				--lowerLeft.x;
-				++lowerLeft.y;
-			}
-
-			sf::Vector2i upperRight = queenPos;
-			for (int x = 0; x < m_queensAmount; ++x)
-			{
-				if (upperRight.x >= m_queensAmount - 1 || upperRight.y <= 0)
-					break;
-				++upperRight.x;
-				--upperRight.y;
-			}
-
-			sf::VertexArray vertices(sf::PrimitiveType::Lines, 2);
-			vertices[0] = { sf::Vector2f(m_queenMiddlePointPixelXCoordLUT[lowerLeft.x] - queenPixelHalf, m_queenMiddlePointPixelYCoordLUT[lowerLeft.y] + queenPixelHalf), queenColor };
-			vertices[1] = { sf::Vector2f(m_queenMiddlePointPixelXCoordLUT[upperRight.x] + queenPixelHalf, m_queenMiddlePointPixelYCoordLUT[upperRight.y] - queenPixelHalf), queenColor };
-			m_resultTexture.draw(vertices);
+			int stepsDown = std::min(queenPos.X, lastIndex - queenPos.Y);
+			int stepsUp = std::min(lastIndex - queenPos.X, queenPos.Y);
+			m_resultPrimitives.push_back({ RasterPrimitiveType::Line,
+				m_queenMiddlePointPixelXCoordLUT[queenPos.X - stepsDown] - queenPixelHalf, m_queenMiddlePointPixelYCoordLUT[queenPos.Y + stepsDown] + queenPixelHalf,
+				m_queenMiddlePointPixelXCoordLUT[queenPos.X + stepsUp] + queenPixelHalf, m_queenMiddlePointPixelYCoordLUT[queenPos.Y - stepsUp] - queenPixelHalf, queenColor });
 		}
 	}
 	return true;
 }
-
-bool NQueensPuzzle::saveResultTextureOnFileSystem() const
-{
-	const std::string fileName = std::to_string(m_queensAmount) + "_queens_puzzle.jpg";
-	if (!m_resultTexture.getTexture().copyToImage().saveToFile(fileName))
-	{
-		std::cerr << "ERROR: Result image creation failed!!";
-		return false;
-	}
-	std::cout << "INFO: Result of '" + std::to_string(m_queensAmount) + " Queens Puzzle' saved in execution path!\n";
-	std::cout << "INFO: Filename: '" + fileName + "'\n";
-	return true;
-}
@@ -1,13 +1,26 @@
 #pragma once
-#include <SFML/Graphics/RenderTexture.hpp>
+#include "GeneticAlgorithm.h"
+#include "RasterImage.h"
+#include "ImageWriter.h"
+#include "../Common/ResultWriter.h"
 
 class NQueensPuzzle
 {
 	//just a wrapper due to early function declarations
+	struct QueenPosition
+	{
+		int X = 0; //column
+		int Y = 0; //row
+	};
 	struct PuzzleResult
 	{
-		std::vector<sf::Vector2i> Positions;
+		std::vector<QueenPosition> Positions; //of the best individual, also if it isn't a solution
 		int NeededIterations;
+		unsigned long long Seed = 0; //of the run, the queen colors are drawn from it
+		bool Solved = false;
+		int BestFitness = 0;
+		long long EvaluationsAmount = 0;
+		double Seconds = 0;
 	};
 public:
 	NQueensPuzzle();
@@ -19,22 +32,48 @@ private:
 	bool parseCommandLine(int argc, char** argv);
 	static void showUsage(char* appExecutionPath);
 	bool solvePuzzle(PuzzleResult& outResult);
+	//independent runs with derived seeds, only the summary is printed and saved, the images of the solved runs are exported in the background
+	bool solveBatch();
+	static void setQueenPositions(const std::vector<int>& chromosome, PuzzleResult& outResult);
+	std::string getResultFileName() const;
+	std::vector<RunParameter> getRunParameters() const;
+	static RunRecord createRunRecord(const PuzzleResult& puzzleResult);
+
+	//the image is drawn and saved in strips of rows, the memory stays at one strip however large the board is
+	bool createAndSaveResultImageOnFileSystem(const PuzzleResult& puzzleResult, const std::string& fileNameSuffix, std::string& outFileName);
+	bool createResultStrips(const int& stripRows, const int& downsampling);
+	void calculateResultImagePixelWidthAndHeight();
+	int calculateStripRows(const int& downsampling) const;
+	void createQueenPosLUT();
+	//the grid and all queens in drawing order, built once in O(N) for all strips and workers
+	bool createResultPrimitives(const PuzzleResult& puzzleResult);
 
-	bool createAndSaveResultTextureOnFileSystem(const PuzzleResult& puzzleResult);
-	bool createResultRenderTexture();
-	void calculateResultTexturePixelWidthHeightAndDimension();
-	void drawGridInResultTextureAndCreateQueenPosLUT();
-	bool drawQueensInResultTexture(const PuzzleResult& puzzleResult);
-	bool saveResultTextureOnFileSystem() const;
-	
 
-	sf::RenderTexture m_resultTexture;
-	sf::Vector2i m_textureDimension;
+	RasterImage m_resultStrip;
+	RasterImage m_overviewStrip; //only with downsampling
+	std::vector<RasterPrimitive> m_resultPrimitives;
 	std::vector<int> m_queenMiddlePointPixelXCoordLUT;
 	std::vector<int> m_queenMiddlePointPixelYCoordLUT;
 	int m_queensAmount;
+	int m_threadsAmount;
+	int m_islandsAmount;
+	int m_migrationInterval;
+	MigrationTopology::Enum m_migrationTopology;
+	GAConfig m_config;
+	unsigned long long m_seed;
+	int m_runsAmount;
+	int m_jobsAmount;
+	int m_statsInterval; //0 -> no stats lines
+	Telemetry m_telemetry;
+	ImageFormat::Enum m_imageFormat;
+	ResultFormat::Enum m_resultFormat;
+	int m_overviewPixel; //0 -> full resolution
+	bool m_exportRuns;
+	int m_exportQueueCapacity;
 	int m_pixelAmount;
 	const int m_queensPixel = 20;
 	const int m_gridPixel = 1;
+	const int m_minRowsPerDrawWorker = 256; //smaller strips are drawn on one thread
+	const size_t m_maxStripBytes = 64 << 20;
 };
 
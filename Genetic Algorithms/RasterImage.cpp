@@ -0,0 +1,182 @@
+#include "RasterImage.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+	//rounds to the nearest integer, halves away from zero, the denominator has to be positive
+	long long roundedDivide(const long long& numerator, const long long& denominator)
+	{
+		return numerator >= 0 ? (2 * numerator + denominator) / (2 * denominator) : -((-2 * numerator + denominator) / (2 * denominator));
+	}
+}
+
+RasterView::RasterView(RgbaColor* firstRowPixels, const int& width, const int& firstRow, const int& endRow)
+	: m_firstRowPixels(firstRowPixels), m_width(width), m_firstRow(firstRow), m_endRow(endRow)
+{
+}
+
+int RasterView::GetWidth() const
+{
+	return m_width;
+}
+
+int RasterView::GetFirstRow() const
+{
+	return m_firstRow;
+}
+
+int RasterView::GetEndRow() const
+{
+	return m_endRow;
+}
+
+void RasterView::Clear(const RgbaColor& color)
+{
+	std::fill(m_firstRowPixels, m_firstRowPixels + static_cast<size_t>(m_endRow - m_firstRow) * m_width, color);
+}
+
+void RasterView::FillRect(int left, int top, int right, int bottom, const RgbaColor& color)
+{
+	left = std::max(left, 0);
+	right = std::min(right, m_width);
+	top = std::max(top, m_firstRow);
+	bottom = std::min(bottom, m_endRow);
+	if (left >= right)
+		return;
+
+	for (int y = top; y < bottom; ++y)
+	{
+		RgbaColor* row = m_firstRowPixels + static_cast<size_t>(y - m_firstRow) * m_width;
+		std::fill(row + left, row + right, color);
+	}
+}
+
+void RasterView::DrawLine(const int& x0, const int& y0, const int& x1, const int& y1, const RgbaColor& color)
+{
+	long long dx = x1 - x0;
+	long long dy = y1 - y0;
+	if (std::abs(dy) >= std::abs(dx))
+	{
+		//steep, one pixel per row, only the own rows are visited
+		if (dy == 0)
+		{
+			FillRect(x0, y0, x0 + 1, y0 + 1, color);
+			return;
+		}
+		if (dy < 0)
+		{
+			DrawLine(x1, y1, x0, y0, color);
+			return;
+		}
+		int top = std::max(y0, m_firstRow);
+		int bottom = std::min(y1 + 1, m_endRow);
+		for (int y = top; y < bottom; ++y)
+		{
+			long long x = x0 + roundedDivide((y - y0) * dx, dy);
+			if (x >= 0 && x < m_width)
+				m_firstRowPixels[static_cast<size_t>(y - m_firstRow) * m_width + x] = color;
+		}
+	}
+	else
+	{
+		//flat, one pixel per column
+		if (dx < 0)
+		{
+			DrawLine(x1, y1, x0, y0, color);
+			return;
+		}
+		int left = std::max(x0, 0);
+		int right = std::min(x1 + 1, m_width);
+		for (int x = left; x < right; ++x)
+		{
+			long long y = y0 + roundedDivide((x - x0) * dy, dx);
+			if (y >= m_firstRow && y < m_endRow)
+				m_firstRowPixels[static_cast<size_t>(y - m_firstRow) * m_width + x] = color;
+		}
+	}
+}
+
+void RasterView::Draw(const std::vector<RasterPrimitive>& primitives)
+{
+	for (auto& primitive : primitives)
+	{
+		//most primitives of a large image are outside of the rows of one strip
+		if (std::max(primitive.Y0, primitive.Y1) < m_firstRow || std::min(primitive.Y0, primitive.Y1) >= m_endRow)
+			continue;
+		if (primitive.Type == RasterPrimitiveType::Rect)
+			FillRect(primitive.X0, primitive.Y0, primitive.X1, primitive.Y1, primitive.Color);
+		else
+			DrawLine(primitive.X0, primitive.Y0, primitive.X1, primitive.Y1, primitive.Color);
+	}
+}
+
+RasterImage::RasterImage() : m_width(0), m_height(0), m_firstRow(0)
+{
+}
+
+void RasterImage::Resize(const int& width, const int& height, const int& firstRow)
+{
+	m_width = width;
+	m_height = height;
+	m_firstRow = firstRow;
+	m_pixels.resize(static_cast<size_t>(width) * height);
+}
+
+int RasterImage::GetWidth() const
+{
+	return m_width;
+}
+
+int RasterImage::GetHeight() const
+{
+	return m_height;
+}
+
+int RasterImage::GetFirstRow() const
+{
+	return m_firstRow;
+}
+
+const RgbaColor* RasterImage::GetPixels() const
+{
+	return m_pixels.data();
+}
+
+RasterView RasterImage::GetView(const int& firstRow, const int& endRow)
+{
+	return RasterView(m_pixels.data() + static_cast<size_t>(firstRow - m_firstRow) * m_width, m_width, firstRow, endRow);
+}
+
+void RasterImage::Downsample(const int& factor, const int& firstRow, const int& endRow, RasterImage& target) const
+{
+	std::vector<unsigned long long> sums(4 * static_cast<size_t>(target.m_width));
+	for (int blockRow = firstRow; blockRow < endRow; blockRow += factor)
+	{
+		int blockEndRow = std::min(blockRow + factor, endRow);
+		std::fill(sums.begin(), sums.end(), 0);
+		for (int y = blockRow; y < blockEndRow; ++y)
+		{
+			const RgbaColor* row = m_pixels.data() + static_cast<size_t>(y - m_firstRow) * m_width;
+			for (int x = 0; x < m_width; ++x)
+			{
+				unsigned long long* sum = &sums[4 * (x / factor)];
+				sum[0] += row[x].R;
+				sum[1] += row[x].G;
+				sum[2] += row[x].B;
+				sum[3] += row[x].A;
+			}
+		}
+
+		RgbaColor* targetRow = target.m_pixels.data() + static_cast<size_t>(blockRow / factor - target.m_firstRow) * target.m_width;
+		for (int x = 0; x < target.m_width; ++x)
+		{
+			unsigned long long pixelsAmount = static_cast<unsigned long long>(blockEndRow - blockRow) * (std::min((x + 1) * factor, m_width) - x * factor);
+			const unsigned long long* sum = &sums[4 * x];
+			unsigned char channels[4];
+			for (int channel = 0; channel < 4; ++channel)
+				channels[channel] = static_cast<unsigned char>((sum[channel] + pixelsAmount / 2) / pixelsAmount);
+			targetRow[x] = RgbaColor(channels[0], channels[1], channels[2], channels[3]);
+		}
+	}
+}
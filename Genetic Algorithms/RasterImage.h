@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+
+struct RgbaColor
+{
+	RgbaColor() {}
+	RgbaColor(const unsigned char& r, const unsigned char& g, const unsigned char& b, const unsigned char& a = 255) : R(r), G(g), B(b), A(a) {}
+
+	unsigned char R = 0;
+	unsigned char G = 0;
+	unsigned char B = 0;
+	unsigned char A = 255;
+};
+//the rows are written into RGBA images as they are
+static_assert(sizeof(RgbaColor) == 4, "RgbaColor needs to be 4 bytes without padding");
+
+namespace RasterPrimitiveType
+{
+	enum Enum
+	{
+		Rect, //filled, right and bottom are exclusive
+		Line //one pixel wide, both end points are drawn
+	};
+}
+
+struct RasterPrimitive
+{
+	RasterPrimitiveType::Enum Type;
+	int X0; //left or start
+	int Y0; //top or start
+	int X1; //right or end
+	int Y1; //bottom or end
+	RgbaColor Color;
+};
+
+//rows [FirstRow, EndRow) of an image, every draw call is clipped to them, so workers with their own rows can draw into the same image
+class RasterView
+{
+public:
+	RasterView(RgbaColor* firstRowPixels, const int& width, const int& firstRow, const int& endRow);
+
+	int GetWidth() const;
+	int GetFirstRow() const;
+	int GetEndRow() const;
+
+	void Clear(const RgbaColor& color);
+	//right and bottom are exclusive
+	void FillRect(int left, int top, int right, int bottom, const RgbaColor& color);
+	//one pixel wide, both end points are drawn
+	void DrawLine(const int& x0, const int& y0, const int& x1, const int& y1, const RgbaColor& color);
+	//draws all primitives in their order, the later ones on top
+	void Draw(const std::vector<RasterPrimitive>& primitives);
+
+private:
+	RgbaColor* m_firstRowPixels;
+	int m_width;
+	int m_firstRow;
+	int m_endRow;
+};
+
+//RGBA pixels of the rows [FirstRow, FirstRow + Height) of an image, from top to bottom, a strip of a larger image or the whole one
+class RasterImage
+{
+public:
+	RasterImage();
+
+	void Resize(const int& width, const int& height, const int& firstRow = 0);
+	int GetWidth() const;
+	int GetHeight() const;
+	int GetFirstRow() const;
+	const RgbaColor* GetPixels() const;
+
+	//rows in image coordinates
+	RasterView GetView(const int& firstRow, const int& endRow);
+	//averages every factor x factor block of the rows [firstRow, endRow) into one pixel of target, whose rows are the image rows divided by factor
+	//firstRow has to be a multiple of factor, endRow as well unless it's the end of the image, where the blocks may be smaller
+	void Downsample(const int& factor, const int& firstRow, const int& endRow, RasterImage& target) const;
+
+private:
+	std::vector<RgbaColor> m_pixels;
+	int m_width;
+	int m_height;
+	int m_firstRow;
+};